@@ -4,7 +4,12 @@ UNIVERSITY RIDE SHARE SYSTEM
 ===============================================================================
 Purpose: Help students find ride-sharing partners going to the same destination
 Features: Register students, search by destination, view all students, clear data
-Data Storage: Text file (ride_share_data.txt) for persistent storage
+Modes: Interactive menu (no arguments), command line (./ride_share help),
+       or a multi-client server on a local socket (./ride_share serve)
+Data Storage: Text file (ride_share_data.txt) for persistent storage,
+              plus an append-only change log (ride_share_data.log)
+              and an optional binary snapshot (ride_share_data.bin)
+Memory Model: The file is loaded ONCE at startup into a growable StudentStore
 ===============================================================================
 */
 
@@ -13,494 +18,6271 @@ Data Storage: Text file (ride_share_data.txt) for persistent storage
 #include <cstring>   // For C-style string functions (strcpy, strcmp, strlen)
 #include <string>    // For modern C++ string class (not heavily used here)
 #include <cstdio>    // For standard C input/output functions
+#include <vector>    // For std::vector (growable array used by StudentStore)
+#include <chrono>    // For measuring how long loading the database takes
+#include <unordered_map> // For the hash index on destination
+#include <algorithm> // For lower_bound (keeps index lists sorted)
+#include <cctype>    // For tolower (normalizing index keys)
+#include <cstdlib>   // For atoi, rand, srand
+#include <cstdint>   // For fixed-width integers (uint32_t) in the binary format
+#include <map>       // For sorted maps (binary snapshot destination directory)
+#include <cmath>     // For sqrt, floor (distances between places)
+#include <thread>    // For std::thread (parallel ride group formation)
+#include <atomic>    // For std::atomic (sharing work between threads)
+#include <mutex>     // For std::mutex (server write queue)
+#include <condition_variable> // For waking the server's writer thread
+#include <future>    // For std::promise (waiting for a queued write to finish)
+#include <memory>    // For std::shared_ptr (server snapshots)
+#include <random>    // For std::mt19937 (repeatable synthetic rosters)
+#include <sstream>   // For std::ostringstream (timing the list output)
+#include <deque>     // For std::deque (place names that never move in memory)
+#include <ctime>     // For time() (registration timestamps and departure windows)
+#include <sys/stat.h> // For stat() (file size and modification time)
+
+// SSE2 / AVX2 intrinsics for the delimiter scan (plain C++ is used elsewhere)
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define RIDE_SHARE_X86 1
+#else
+#define RIDE_SHARE_X86 0
+#endif
+
+#ifndef _WIN32
+#include <sys/mman.h> // For mmap() (mapping the binary snapshot into memory)
+#include <fcntl.h>    // For open()
+#include <unistd.h>   // For close()
+#include <sys/socket.h> // For the server's Unix-domain socket
+#include <sys/un.h>     // For sockaddr_un
+#include <signal.h>     // For ignoring SIGPIPE when a client disconnects
+#endif
 
 using namespace std; // Allows us to write 'cout' instead of 'std::cout'
 
 /*
 ===============================================================================
-STRUCT DEFINITION: Student Record
+STRUCT DEFINITION: StudentForm
 ===============================================================================
 This is like a template/blueprint for storing student information.
 Think of it as a form with 3 fields that we'll fill out for each student.
+It is what the menu, the command line, the change log and the server fill
+in before handing a student to the StudentStore. std::string fields mean
+long names are kept in full instead of being cut off at 49 characters.
+*/
+struct StudentForm {
+    string name;            // Student's name
+    string destination;     // Where they want to go (e.g., "Saddar", "Hayatabad")
+    string currentLocation; // Where they are now (e.g., "Library", "Cafe")
+
+    /*
+    Times in seconds since 1970 (Unix time); 0 = not given, in which case the
+    store fills in "now" and a window of DEFAULT_DEPARTURE_WINDOW_MIN minutes.
+    The student can leave any time between departFrom and departUntil;
+    after departUntil the registration has expired.
+    */
+    uint32_t registeredAt;
+    uint32_t departFrom;
+    uint32_t departUntil;
+
+    StudentForm() : registeredAt(0), departFrom(0), departUntil(0) {}
+};
+
+/*
+===============================================================================
+STRUCT DEFINITION: Student Record
+===============================================================================
+How the StudentStore keeps each student in memory: 32 bytes instead of the
+old three char[50] buffers (150 bytes).
+- Destinations and locations come from a few dozen campus places, so each
+  distinct spelling is stored ONCE in a PlacePool and the record only keeps
+  its number (place id).
+- Names are all different, so they are copied into a StringArena (big shared
+  blocks of text) and the record points at its name there.
 */
 struct Student {
-    char name[50];            // Student's name (max 49 characters + null terminator)
-    char destination[50];     // Where they want to go (e.g., "Saddar", "Hayatabad")
-    char currentLocation[50]; // Where they are now (e.g., "Library", "Cafe")
+    const char* name;         // Full name, inside the store's StringArena
+    uint32_t destination;     // Place id of where they want to go
+    uint32_t currentLocation; // Place id of where they are now
+    uint32_t registeredAt;    // When they registered (Unix time)
+    uint32_t departFrom;      // Departure window start (Unix time)
+    uint32_t departUntil;     // Departure window end: expired after this
+};
+
+/*
+Read-only view of one stored student, with the place ids already turned
+back into text. Returned by StudentStore::at(); only valid until the store
+is next changed.
+*/
+struct StudentView {
+    const char* name;
+    const char* destination;
+    const char* currentLocation;
+    uint32_t registeredAt;
+    uint32_t departFrom;
+    uint32_t departUntil;
 };
 
+// View of a StudentForm (valid while the form is)
+StudentView viewOf(const StudentForm& s);
+
+// Can two students leave together? True if their departure windows overlap
+bool windowsOverlap(uint32_t fromA, uint32_t untilA, uint32_t fromB, uint32_t untilB);
+
+// The current time in seconds since 1970
+uint32_t nowSeconds();
+
+// Set s's departure window: leaving in leaveInMin minutes, for windowMin minutes
+void setDepartureWindow(StudentForm& s, int leaveInMin, int windowMin);
+
+// Turn a place name into an index key: "SaDdAr" -> "saddar"
+string normalizeKey(const char* text);
+
 /*
 ===============================================================================
-FUNCTION PROTOTYPES (Forward Declarations)
+CLASS DEFINITION: PlaceDirectory
 ===============================================================================
-These tell the compiler: "These functions exist below, trust me!"
-It's like a table of contents for your program.
+Knows where named places are, as (x, y) coordinates in kilometres on a flat
+city map. Both destinations ("Saddar") and current locations ("Library")
+are looked up here. A set of well-known places is built in, and more can be
+added (or corrected) in PLACES_FILE, one per line:
+    Name|x|y        e.g.  Phase 3 Chowk|-8.2|-1.5
+Places that are not in the directory simply have no coordinates; students
+there can still be found by exact destination, just not ranked by distance.
 */
-void registerStudent();                              // Register new student or update existing
-void findRidePartners();                             // Search for students going to same destination
-void viewAllStudents();                              // Display all registered students
-void clearAllData();                                 // Delete all student records
-void showMenu();                                     // Display menu options
-void ensureFileExists();                             // Create database file if it doesn't exist
-int loadStudentsFromFile(Student arr[], int maxSize); // Load students from file into array
-void saveAllStudentsToFile(Student arr[], int count); // Save students from array to file
+struct Point {
+    double x, y; // Kilometres east / north of the city reference point
+};
 
-// Global constant: The name of our database file
-// Using const means this value can never be changed
-const char* DB_FILE = "ride_share_data.txt";
+// Straight-line distance between two points, in kilometres
+double distanceKm(Point a, Point b);
+
+class PlaceDirectory {
+public:
+    PlaceDirectory(); // Fills in the built-in places
+
+    void set(const char* name, double x, double y); // Add or move a place
+    bool lookup(const char* name, Point& where) const; // false if unknown
+    int loadFile(const char* path); // Read extra places; returns how many
+
+private:
+    unordered_map<string, Point> places; // lower-cased name -> coordinates
+};
 
 /*
 ===============================================================================
-MAIN FUNCTION - Program Entry Point
+CLASS DEFINITION: ProximityIndex
 ===============================================================================
-This is where the program ALWAYS starts executing.
-Every C++ program must have exactly one main() function.
+A spatial index used to rank ride partners by how close they are.
+For every destination it keeps a uniform grid of square cells
+(PROXIMITY_CELL_KM wide); each cell lists the students whose CURRENT
+location falls inside it. A query starts in the searcher's own cell and
+walks outwards ring by ring, stopping as soon as no unvisited cell can hold
+anyone closer than the k-th best match found so far. Cost therefore depends
+on how many students are near you, not on the size of the roster.
 */
-int main() {
-    // Step 1: Make sure our database file exists before we start
-    ensureFileExists();
-    
-    // Variable to store user's menu choice (1-5)
-    int choice;
-    
-    // Welcome message
-    cout << "*** Welcome to University Ride Share System ***\n";
-    cout << "Data is permanently stored in: " << DB_FILE << "\n";
-    
+struct NearbyMatch {
+    int id;            // Position of the student in the store
+    double distanceKm; // Distance from the searcher's current location
+};
+
+class ProximityIndex {
+public:
+    // Add / remove a student (position id) going to destKey, currently at 'where'
+    void insert(int id, const string& destKey, Point where);
+    void erase(int id, const string& destKey, Point where);
+    void clear() { grids.clear(); }
+
     /*
-    Main Program Loop - Keeps running until user chooses to exit
-    while(true) creates an infinite loop that only stops when we use 'break'
+    Find up to k students closest to 'from' whose destination is destKey or
+    any known destination within radiusKm of it. Results are sorted by
+    distance (closest first).
     */
-    while (true) {
-        // Display the menu options to user
-        showMenu();
-        
-        // Ask user to enter their choice
-        cout << "\nEnter your choice: ";
-        
-        /*
-        Input Validation: Check if user entered a valid number
-        !(cin >> choice) returns true if input FAILS (e.g., user types letters)
-        */
-        if (!(cin >> choice)) {
-            cout << "Invalid input. Please enter a number.\n";
-            cin.clear();              // Clear the error flag on cin
-            cin.ignore(1000, '\n');   // Discard invalid input up to 1000 chars or newline
-            continue;                 // Skip rest of loop, go back to start (show menu again)
-        }
-        
-        /*
-        Clear the newline character left in buffer after reading the number
-        When user types "3" and presses Enter, cin >> choice reads "3" but leaves "\n"
-        cin.ignore() removes that leftover newline so it doesn't interfere with getline() later
-        */
-        cin.ignore();
+    void nearest(const string& destKey, Point from, int k, double radiusKm,
+                 vector<NearbyMatch>& out) const;
 
-        /*
-        Menu Selection Logic
-        Based on what number user entered, call the appropriate function
-        */
-        if (choice == 1) {
-            registerStudent();    // Option 1: Register or update student info
-        } 
-        else if (choice == 2) {
-            findRidePartners();   // Option 2: Search for ride partners
-        } 
-        else if (choice == 3) {
-            viewAllStudents();    // Option 3: View all registered students
-        } 
-        else if (choice == 4) {
-            clearAllData();       // Option 4: Delete all data
-        } 
-        else if (choice == 5) {
-            cout << "Exiting application. Goodbye!\n";
-            break;                // Exit the while loop (ends program)
-        } 
-        else {
-            cout << "Invalid choice. Try again.\n";
-        }
-        
-        // Print a separator line for better readability
-        cout << "\n----------------------------------------\n";
+private:
+    struct Entry {
+        int id;
+        Point where;
+    };
+    struct DestGrid {
+        bool hasPoint;  // Whether the destination itself has coordinates
+        Point point;    // Where the destination is (if hasPoint)
+        int minCx, maxCx, minCy, maxCy; // Bounding box of used cells
+        unordered_map<long long, vector<Entry> > cells;
+    };
+    unordered_map<string, DestGrid> grids; // lower-cased destination -> grid
+};
+
+/*
+===============================================================================
+CLASS DEFINITION: PlaceSearchIndex
+===============================================================================
+A trie (prefix tree) of every distinct destination and current location,
+lower-cased, with how many students use each one. It powers:
+- Autocomplete: "hay" -> "Hayatabad" (walk down 3 letters, list what is below)
+- Typo tolerance: "Sadar" -> "Saddar" (edit distance <= 2), by walking the
+  trie while filling one row of the Levenshtein table per letter, and
+  skipping whole branches once every entry in the row is already too big
+- Longer queries: "Hayatabad Phase 3" -> "Hayatabad", because a known place
+  that ends at a word boundary of the query is reported too
+The trie only holds DISTINCT places (a few hundred or thousand), not one
+entry per student, so searches stay fast however big the roster gets.
+StudentStore updates it on every add / update / remove.
+*/
+struct PlaceSuggestion {
+    string text;  // Place as first written by a student
+    int students; // How many students use it
+    int edits;    // Typos corrected to reach it (0 = exact or prefix match)
+};
+
+class PlaceSearchIndex {
+public:
+    enum Field { DESTINATION = 0, LOCATION = 1 };
+
+    PlaceSearchIndex() { clear(); }
+
+    // Count one more (delta = +1) or one fewer (delta = -1) student using 'text'
+    void add(const char* text, Field field, int delta);
+    void clear();
+
+    // Places starting with 'prefix', most popular first
+    void complete(const char* prefix, Field field, int limit, vector<PlaceSuggestion>& out) const;
+
+    // Places within maxEdits typos of 'text', closest then most popular first
+    void fuzzy(const char* text, Field field, int maxEdits, int limit, vector<PlaceSuggestion>& out) const;
+
+    /*
+    "Did you mean?" for a search that found nothing: combines completions,
+    places that are a leading word group of the query, and fuzzy matches
+    (up to 2 typos). Each place appears once.
+    */
+    void suggest(const char* text, Field field, int limit, vector<PlaceSuggestion>& out) const;
+
+private:
+    struct Node {
+        vector<pair<char, int> > children; // (letter, node) sorted by letter
+        int count[2];                      // Students using this place, per Field
+        string display;                    // Original spelling (set on first use)
+        Node() { count[0] = count[1] = 0; }
+    };
+    vector<Node> nodes; // nodes[0] is the root
+
+    int child(int node, char c) const; // -1 if there is no such child
+    void collect(int node, Field field, vector<pair<int, int> >& out) const;
+    void fuzzyWalk(int node, char c, const string& word, const vector<int>& prevRow,
+                   Field field, int maxEdits, vector<PlaceSuggestion>& out) const;
+};
+
+/*
+===============================================================================
+CLASS DEFINITION: PlacePool
+===============================================================================
+Interns place names: every distinct spelling ("Saddar", "saddar", "Library")
+is stored once and gets a small number, its place id. Each spelling is also
+mapped to a KEY id shared by every spelling that only differs in upper/lower
+case, so "Saddar" and "SADDAR" have different place ids but the same key.
+Comparing two places ignoring case is then one integer compare:
+    pool.key(a) == pool.key(b)      instead of     strcasecmp(a, b) == 0
+Places are never removed (a campus only has a few dozen), only clear()ed.
+*/
+class PlacePool {
+public:
+    uint32_t intern(const char* text);     // Place id for this exact spelling (added if new)
+    int findKey(const char* text) const;   // Key id for text in any case, or -1 if unknown
+
+    const char* text(uint32_t id) const { return spellings[id].c_str(); }
+    uint32_t key(uint32_t id) const { return keyOf[id]; }
+    const string& keyText(uint32_t key) const { return keys[key]; } // Lower-cased
+    int keyCount() const { return (int)keys.size(); }
+    size_t memoryBytes() const; // Rough heap use, for the benchmarks
+
+    void clear();
+
+private:
+    deque<string> spellings;              // Place id -> text (a deque never moves its strings)
+    vector<uint32_t> keyOf;               // Place id -> key id
+    unordered_map<string, uint32_t> ids;  // Exact text -> place id
+    deque<string> keys;                   // Key id -> lower-cased text
+    unordered_map<string, uint32_t> keyIds; // Lower-cased text -> key id
+};
+
+/*
+===============================================================================
+CLASS DEFINITION: StringArena
+===============================================================================
+Stores many short strings (student names) back to back in large blocks,
+instead of one heap allocation (or one fixed char[50]) per string. Strings
+never move once added, so a plain const char* can point at them. Removing a
+string only counts its bytes as wasted; the owner rebuilds the arena when
+the waste gets large (see StudentStore::remove()).
+*/
+class StringArena {
+public:
+    StringArena() : cursor(NULL), blockFree(0), used(0), wasted(0), reserved(0) {}
+
+    const char* add(const char* text);           // Copy text (with its '\0') in
+    void release(const char* text) { wasted += strlen(text) + 1; }
+    size_t bytesUsed() const { return used; }     // Bytes of text added
+    size_t bytesWasted() const { return wasted; } // Bytes belonging to released strings
+    size_t memoryBytes() const { return reserved; } // Bytes of blocks allocated
+    void swap(StringArena& other);
+    void clear();
+
+private:
+    vector<unique_ptr<char[]> > blocks;
+    char* cursor;     // Next free byte in the newest block
+    size_t blockFree; // Bytes left after cursor
+    size_t used, wasted, reserved;
+};
+
+/*
+===============================================================================
+CLASS DEFINITION: NameIndex
+===============================================================================
+A hash table from a student's name (ignoring case) to their position in the
+store, so "is this student already registered?" costs the same with ten
+students or a million. It is an open-addressing table: one flat array of
+slots, where a name that lands on a used slot tries the next one along.
+Each slot only holds the name's hash and the record position; the name
+itself is read from the record, so no name is stored twice.
+The table is kept at most half full, which keeps the runs of used slots short.
+*/
+class NameIndex {
+public:
+    NameIndex() : used(0) {}
+
+    // Position of the student called 'name' (any case), or -1
+    int find(const char* name, const vector<Student>& students) const;
+
+    void insert(int pos, const vector<Student>& students); // students[pos] was added
+    void erase(int pos, const vector<Student>& students);  // students[pos] is about to go
+    void move(int from, int to, const vector<Student>& students); // students[to] is now students[from]
+    void reserve(int n);
+    void clear();
+    size_t memoryBytes() const { return slots.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint32_t hash; // Hash of the lower-cased name
+        int pos;       // Record position, or -1 if the slot is empty
+    };
+    vector<Slot> slots; // Size is always a power of two (or zero)
+    int used;
+
+    int slotOf(int pos, const vector<Student>& students) const; // Slot holding pos
+    void grow(size_t size); // Re-spread every entry over 'size' slots
+};
+
+/*
+===============================================================================
+CLASS DEFINITION: StudentStore
+===============================================================================
+Owns every Student record kept in memory.
+The records live in a std::vector, which grows on the heap as students are
+added, so there is no fixed limit like the old "Student students[100]" arrays.
+main() loads the store once at startup and passes it to every menu action,
+so searching or listing no longer re-reads the whole file each time.
+Place names are interned in a PlacePool and names kept in a StringArena,
+so each record is only 16 bytes (see the Student struct).
+
+Destination Index:
+The store also keeps an index from each destination's key id (see PlacePool)
+to the positions of every student going there (e.g. "saddar" -> {0, 4, 17}).
+Finding ride partners then only touches the matching students instead of
+scanning the whole roster. add() and update() keep the index in sync, which
+is why records can only be changed through those functions.
+The same functions also keep a ProximityIndex up to date, so partners can be
+ranked by distance from the searcher (see findNearest()), and a
+PlaceSearchIndex for autocomplete and typo-tolerant place search.
+
+Name Index:
+A NameIndex finds a student by name in constant time, so registering or
+updating a student no longer compares the name against every record.
+*/
+class StudentStore {
+public:
+    StudentStore() : everythingChanged(true) {} // Nothing of a new store is saved yet
+
+    int size() const { return (int)students.size(); }  // Number of records
+    bool empty() const { return students.empty(); }    // True if no records
+
+    // Read the record at position i (0 <= i < size())
+    StudentView at(int i) const {
+        const Student& s = students[i];
+        StudentView v = { s.name, placeNames.text(s.destination), placeNames.text(s.currentLocation),
+                          s.registeredAt, s.departFrom, s.departUntil };
+        return v;
+    }
+
+    // Case-insensitive destination key id of record i (compare these, not strings)
+    uint32_t destinationKey(int i) const { return placeNames.key(students[i].destination); }
+
+    // Key id for a destination typed in any case, or -1 if no one has used it
+    int findDestinationKey(const char* destination) const { return placeNames.findKey(destination); }
+
+    // Append a new record to the end of the store
+    void add(const StudentForm& s);
+    void add(const StudentView& s); // Same, straight from text that is not in strings
+
+    // Make room for n records up front (avoids repeated reallocation)
+    void reserve(int n) { students.reserve(n); byName.reserve(n); }
+
+    // Change the destination, location and departure window of the record at position i
+    void update(int i, const StudentForm& s);
+
+    /*
+    Remove every student whose departure window ended before 'now'.
+    Students are kept in time buckets by departUntil, so this only looks at
+    buckets that have fully expired: O(1) amortized per student, and
+    students still waiting are never scanned. Returns how many were removed.
+    */
+    int expire(uint32_t now);
+
+    // Delete the record at position i (the last record moves into its place)
+    void remove(int i);
+
+    // Case-insensitive name search using the name index. Returns the position, or -1 if not found
+    int findByName(const char* name) const { return byName.find(name, students); }
+
+    /*
+    Case-insensitive destination lookup using the index.
+    Returns the positions of all matching students in file order,
+    or NULL if nobody is going there.
+    */
+    const vector<int>* findByDestination(const char* destination) const;
+
+    /*
+    Find the k students closest to 'fromLocation' who are going to
+    'destination' or to a known place within radiusKm of it.
+    Returns false (and finds nothing) if fromLocation has no coordinates.
+    */
+    bool findNearest(const char* destination, const char* fromLocation, int k,
+                     double radiusKm, vector<NearbyMatch>& out) const;
+
+    // Every destination's list of positions (one list per lower-cased destination)
+    void destinationLists(vector<const vector<int>*>& out) const;
+
+    /*
+    Destination keys one by one (key ids run from 0 to destinationKeyCount() - 1),
+    with their lower-cased text and the positions of the students going there
+    */
+    int destinationKeyCount() const { return placeNames.keyCount(); }
+    const string& destinationKeyText(uint32_t key) const { return placeNames.keyText(key); }
+    const vector<int>& studentsGoingTo(uint32_t key) const;
+
+    /*
+    Which destinations changed since the last markSaved(), so a sharded
+    database only rewrites the shards that hold them. A new or cleared store
+    counts as completely changed.
+    */
+    bool destinationChanged(uint32_t key) const {
+        return everythingChanged || (key < changedKeys.size() && changedKeys[key]);
+    }
+    bool allChanged() const { return everythingChanged; }
+    void markSaved() { everythingChanged = false; changedKeys.assign(changedKeys.size(), 0); }
+
+    // Autocomplete / fuzzy search over the destinations and locations in use
+    const PlaceSearchIndex& placeSearch() const { return places; }
+
+    // Remove every record and give the memory back to the system
+    void clear();
+
+    // Rough heap use of the records, names and places (for the benchmarks)
+    size_t memoryBytes() const;
+
+private:
+    vector<Student> students;                          // All records, in file order
+    PlacePool placeNames;                              // Interned destinations and locations
+    StringArena names;                                 // Every student's name
+    NameIndex byName;                                  // lower-cased name -> position
+    map<uint32_t, vector<int> > expiry;                // departUntil bucket -> positions (may be stale)
+    vector<vector<int> > destIndex;                    // destination key id -> positions
+
+    ProximityIndex nearby;                             // destination -> grid of current locations
+    PlaceSearchIndex places;                           // trie of destinations and locations in use
+
+    vector<char> changedKeys;                          // destination key id -> changed since markSaved()?
+    bool everythingChanged;
+
+    void indexDestination(int i);   // Add position i under its destination key
+    void unindexDestination(int i); // Remove position i from its destination key
+    void indexProximity(int i);     // Add position i to the proximity grid (if its location is known)
+    void unindexProximity(int i);   // Remove position i from the proximity grid
+    void indexPlaces(int i, int delta); // Count position i's places in the trie (+1 / -1)
+    void indexExpiry(int i);        // File position i under its departUntil bucket
+    void markChanged(uint32_t key); // Remember that this destination's students changed
+    void indexRecord(int i) { indexDestination(i); indexProximity(i); indexPlaces(i, +1); indexExpiry(i); }
+    void repackNames(); // Rebuild the name arena without the released names
+    void unindexRecord(int i) { unindexDestination(i); unindexProximity(i); indexPlaces(i, -1); }
+
+    // Binary loading copies the prebuilt destination directory straight in
+    friend int loadStudentsFromBinary(StudentStore& store, const class BinarySnapshot& snapshot);
+};
+
+/*
+===============================================================================
+CLASS DEFINITION: RosterGenerator
+===============================================================================
+Makes up realistic-looking synthetic students for benchmarks and for the
+"generate" command. RosterSpec says what the roster should look like; the
+same spec and seed always give exactly the same students.
+*/
+struct RosterSpec {
+    int students;     // How many students
+    int destinations; // How many distinct destinations
+    double skew;      // 0 = every destination equally popular; higher = a few very popular ones
+    int nameLength;   // Typical name length in letters (0 = plain "Student N")
+    unsigned seed;    // Random seed
+
+    RosterSpec() : students(100000), destinations(200), skew(0.0), nameLength(0), seed(42) {}
+};
+
+class RosterGenerator {
+public:
+    explicit RosterGenerator(const RosterSpec& spec);
+    void next(int index, StudentForm& s); // Fill in student number 'index'
+
+private:
+    RosterSpec spec;
+    mt19937 rng;
+    vector<double> cumulative; // Running total of destination weights (Zipf)
+};
+
+/*
+===============================================================================
+STRUCT DEFINITION: RideGroup
+===============================================================================
+One vehicle's worth of students going to the same destination, as formed by
+formRideGroups(). The first member is where the vehicle starts; it then
+collects the others, nearest first, and drives to the destination.
+*/
+struct RideGroup {
+    string destination;  // Destination as written by the first member
+    vector<int> members; // Store positions, in pickup order
+    bool hasRoute;       // false if some location or the destination is unknown
+    double detourKm;     // Extra distance vs. the first member riding alone
+};
+
+/*
+Form vehicle-sized groups out of every registered student.
+Each destination is a separate "shard" and shards are processed in
+parallel on 'threads' worker threads (0 = one per CPU core).
+*/
+void formRideGroups(const StudentStore& store, int capacity, int threads, vector<RideGroup>& groups);
+
+/*
+===============================================================================
+CLASS DEFINITION: ChangeLog
+===============================================================================
+An append-only "write-ahead" log of changes made since the last snapshot.
+Rewriting the whole DB_FILE for every registration gets slower as the roster
+grows, so instead each change is appended as ONE short line:
+    U|Name|Destination|CurrentLocation|RegisteredAt|DepartFrom|DepartUntil
+                                         (register or update a student)
+    D|Name                               (delete a student)
+On startup the log is replayed on top of DB_FILE, so nothing is lost if the
+program stops unexpectedly. Once the log gets long, compaction writes a fresh
+snapshot to DB_FILE and empties the log again.
+*/
+class ChangeLog {
+public:
+    explicit ChangeLog(const char* path) : path(path), entryCount(0) {}
+
+    void logUpsert(const StudentForm& s); // Append a "U" line
+    void logDelete(const char* name);   // Append a "D" line
+
+    // Apply every complete entry in the log to the store. Returns entries applied
+    int replay(StudentStore& store);
+
+    // Empty the log (called once its changes are safely in DB_FILE)
+    void reset();
+
+    int entries() const { return entryCount; } // Entries written since the last snapshot
+
+private:
+    const char* path;  // Log file name
+    ofstream out;      // Kept open in append mode between writes
+    int entryCount;
+
+    bool openForAppend();
+};
+
+/*
+===============================================================================
+CLASS DEFINITION: BinarySnapshot
+===============================================================================
+A read-only view of the optional binary snapshot file (BIN_FILE).
+The text file has to be split line by line and copied field by field; the
+binary file is laid out so it can be memory-mapped and used exactly as it
+sits on disk, with no parsing at all:
+
+    [Header]            magic "RSDB", version, counts and section offsets
+    [Record array]      one fixed-width BinaryRecord per student
+    [Destination dir]   one entry per lower-cased destination, sorted by key
+    [Id array]          record ids for each destination entry, in file order
+    [String table]      every distinct string once, each ending in '\0'
+
+Records hold offsets into the string table, so "Saddar" is stored once no
+matter how many students go there. Numbers are stored in the machine's own
+byte order; the version field lets us change the layout later.
+*/
+struct BinaryHeader {
+    char magic[4];          // Always "RSDB"
+    uint32_t version;       // BINARY_FORMAT_VERSION
+    uint32_t recordCount;   // Number of BinaryRecord entries
+    uint32_t destCount;     // Number of BinaryDestEntry entries
+    uint64_t recordsOffset; // Where the record array starts
+    uint64_t destOffset;    // Where the destination directory starts
+    uint64_t idsOffset;     // Where the id array starts
+    uint64_t stringsOffset; // Where the string table starts
+    uint64_t stringsSize;   // String table length in bytes
+};
+
+struct BinaryRecord {
+    uint32_t nameOff;      // Offset of the name in the string table
+    uint32_t destOff;      // Offset of the destination
+    uint32_t locationOff;  // Offset of the current location
+    uint32_t registeredAt; // Registration time (version 2)
+    uint32_t departFrom;   // Departure window (version 2)
+    uint32_t departUntil;
+};
+
+struct BinaryDestEntry {
+    uint32_t keyOff;  // Offset of the lower-cased destination key
+    uint32_t firstId; // First slot in the id array
+    uint32_t idCount; // Number of students going there
+};
+
+class BinarySnapshot {
+public:
+    BinarySnapshot() : data(NULL), size(0), mapped(false), header(NULL) {}
+    ~BinarySnapshot() { close(); }
+
+    // Map the file and check its header. Returns false if missing or damaged
+    bool open(const char* path);
+    void close();
+
+    int count() const { return (int)header->recordCount; }
+    size_t bytes() const { return size; }
+    const char* name(int i) const { return strings + records[i].nameOff; }
+    const char* destination(int i) const { return strings + records[i].destOff; }
+    const char* currentLocation(int i) const { return strings + records[i].locationOff; }
+    StudentView view(int i) const; // All fields of record i, times included
+
+    /*
+    Find the ids of students going to a destination (case-insensitive)
+    straight from the mapped file, using a binary search of the directory.
+    Returns the number of ids and points *ids at them (0 if none).
+    */
+    int findByDestination(const char* destination, const uint32_t** ids) const;
+
+    // Walk the destination directory: entry d has key destKey(d) and ids destIds(d)
+    int destinationCount() const { return (int)header->destCount; }
+    const char* destKey(int d) const { return strings + dests[d].keyOff; }
+    int destIds(int d, const uint32_t** ids) const {
+        *ids = idList + dests[d].firstId;
+        return (int)dests[d].idCount;
+    }
+
+private:
+    char* data;        // Start of the mapped (or read) file
+    size_t size;       // File size in bytes
+    bool mapped;       // true = mmap'ed, false = read into a heap buffer
+    vector<char> copy; // Heap buffer used where mmap is unavailable
+
+    const BinaryHeader* header;
+    const BinaryRecord* records;
+    const BinaryDestEntry* dests;
+    const uint32_t* idList;
+    const char* strings;
+
+    BinarySnapshot(const BinarySnapshot&);            // Not copyable
+    BinarySnapshot& operator=(const BinarySnapshot&);
+};
+
+// Write the store as a binary snapshot. Returns false on failure
+bool saveBinarySnapshot(const StudentStore& store, const char* path);
+
+// Fill the store from a binary snapshot. Returns the number of students loaded
+int loadStudentsFromBinary(StudentStore& store, const BinarySnapshot& snapshot);
+
+/*
+===============================================================================
+CLASS DEFINITION: RecordLoader
+===============================================================================
+Reads database files (DB_FILE or the shards) in large chunks of whole lines
+and splits them into StudentViews, on as many threads as are given work.
+Splitting runs in two passes over each chunk:
+1. Find the delimiters in bulk: 64 bytes at a time are compared against
+   '|' and '\n' with SIMD instructions (AVX2 or SSE2 when the CPU has
+   them, plain C++ otherwise), giving one bit per byte.
+2. Walk only the set bits: each '|' ends a field and each '\n' a line.
+   The delimiters are overwritten with '\0' so every field is a ready
+   C string pointing into the chunk, and nothing is copied.
+A line with a field longer than MAX_FIELD_BYTES is rejected (skipped and
+counted) instead of being loaded.
+
+Files are read one chunk at a time by whichever thread needs more work;
+reading is done in turn, splitting in parallel. Chunks must be used in
+order with waitFor() and handed back with release(); no more than a few
+chunks per thread are kept ahead of the last one released, so memory use
+does not grow with the file.
+*/
+struct RecordChunk {
+    vector<char> text;        // Whole lines, split in place
+    vector<StudentView> rows; // One per accepted line, pointing into 'text'
+    long rejected;            // Lines with a field that is too long
+    atomic<bool> ready;       // Split and ready to use
+    RecordChunk() : rejected(0), ready(false) {}
+};
+
+// Fills masks[b] with one bit per '|' or '\n' in the 64 bytes at text + 64 * b
+typedef void (*DelimiterScan)(const char* text, size_t blocks, uint64_t* masks);
+
+// The fastest scan this CPU supports, and its name ("avx2", "sse2" or "scalar")
+DelimiterScan bestDelimiterScan(const char** name);
+
+// Split text[0 .. size) (whole lines) in place into rows. Returns lines rejected
+long splitRecords(char* text, size_t size, DelimiterScan scan, vector<StudentView>& rows);
+
+class RecordLoader {
+public:
+    RecordLoader(const vector<string>& paths, int threads);
+
+    // Read and split one more chunk. Returns false if there is none to take right now
+    bool splitNext();
+
+    // Chunk k (0, 1, 2, ... in file order) once it is split, or NULL after the last one.
+    // Splits chunks itself while it waits
+    RecordChunk* waitFor(size_t k);
+
+    // Done with chunk k: its memory is freed and reading may move further ahead
+    void release(size_t k);
+
+    bool finished(); // Every chunk has been handed out
+    uint64_t bytesRead() const { return bytes; }
+
+    static void run(RecordLoader* loader); // Worker thread: split until finished
+
+private:
+    vector<string> paths;   // Files, read one after the other
+    size_t nextPath;
+    ifstream in;            // The file being read
+    vector<char> carry;     // Start of a line cut off at the end of the last chunk
+    deque<RecordChunk> chunks;
+    size_t released;        // Chunks before this have been released
+    size_t maxAhead;        // Chunks that may be read but not released yet
+    bool inputDone;
+    uint64_t bytes;
+    DelimiterScan scan;
+    mutex lock;             // Guards everything above except the chunks' contents
+
+    bool readChunk(vector<char>& text); // false once the input is used up
+};
+
+// Load every file in 'paths' into the store in order. Returns students loaded
+int loadRecordFiles(StudentStore& store, const vector<string>& paths, int threads, long expected);
+
+/*
+===============================================================================
+CLASS DEFINITION: ShardManifest
+===============================================================================
+Optional sharded layout, created with "./ride_share shard [N]". Instead of
+one DB_FILE the students are split over N text files by destination: the
+lower-cased destination is hashed (shardOf()) to pick a shard, so everyone
+going to the same place is in the same file. MANIFEST_FILE lists them:
+
+    ride_share shards 1
+    shard 0 ride_share_data.shard-00.txt 1234     (index, file, students)
+    shard 1 ride_share_data.shard-01.txt 1187
+    ...
+
+Each shard uses the DB_FILE line format, and the change log works on top of
+them exactly as it does on top of DB_FILE. What this buys:
+- a destination search reads one shard instead of the whole roster
+- compaction only rewrites the shards whose destinations changed
+- startup reads and parses the shards on several threads at once
+*/
+struct ShardManifest {
+    vector<string> files; // Shard index -> file name
+    vector<long> counts;  // Students in each shard when it was last written
+
+    int shardCount() const { return (int)files.size(); }
+    bool read(const char* path);        // false if missing or damaged
+    bool write(const char* path) const;
+    void create(int shardCount);        // File names for a new layout, all counts 0
+};
+
+// Which shard (0 .. shardCount - 1) holds a lower-cased destination
+int shardOf(const string& destinationKey, int shardCount);
+
+// True once the database has been sharded (MANIFEST_FILE exists)
+bool isShardedLayout();
+
+// Write the shards holding changed destinations (or every shard), then the manifest
+bool saveShards(const StudentStore& store, ShardManifest& manifest, bool onlyChanged);
+
+// Fill the store from every shard, parsing on up to 'threads' threads (0 = one per core). Returns students loaded
+int loadShards(StudentStore& store, const ShardManifest& manifest, int threads);
+
+// Write a snapshot and empty the log once the log has grown past the threshold
+void compactIfNeeded(StudentStore& store, ChangeLog& changeLog);
+void compactDatabase(StudentStore& store, ChangeLog& changeLog);
+
+/*
+===============================================================================
+CLASS DEFINITION: RowWriter
+===============================================================================
+Formats student rows for listing and writes them out in large chunks.
+Sending every field to cout on its own is slow once there are millions of
+rows, so RowWriter builds the text in a buffer (LIST_BUFFER_BYTES) and hands
+it to the stream in one write whenever the buffer fills up, and at the end.
+Formats:
+    PIPE   Name|Destination|CurrentLocation|RegisteredAt|DepartFrom|DepartUntil
+           (same as the database file)
+    TABLE  #, Name, Destination, Current Location, Leaves (HH:MM-HH:MM local
+           time) separated by tabs (menu style)
+    CSV    name,destination,current_location,registered_at,depart_from,
+           depart_until with quotes where needed
+    JSONL  one {"name":...,"destination":...,"current_location":...,
+           "registered_at":...,"depart_from":...,"depart_until":...} per line
+Times in CSV and JSONL are Unix seconds, like in the file.
+*/
+class RowWriter {
+public:
+    enum Format { PIPE, TABLE, CSV, JSONL };
+
+    RowWriter(ostream& out, Format format);
+    ~RowWriter() { flush(); }
+
+    // "pipe", "table", "csv" or "jsonl" -> Format. Returns false if unknown
+    static bool parseFormat(const char* text, Format& format);
+
+    void header(); // Column names (TABLE and CSV only)
+    void row(long number, const StudentView& s);
+    void flush();  // Write out whatever is buffered
+
+private:
+    ostream& out;
+    Format format;
+    string buffer;
+
+    void appendCsv(const char* field);
+    void appendJson(const char* field);
+    void appendNumber(uint32_t value);
+    void appendClock(uint32_t when); // HH:MM, local time
+};
+
+// Which rows streamStudentList() writes, and how
+struct ListOptions {
+    long offset;              // Matching rows to skip first
+    long limit;               // Most rows to write (-1 = no limit)
+    string destination;       // Only students going here, any case (empty = everyone)
+    RowWriter::Format format;
+
+    ListOptions() : offset(0), limit(-1), format(RowWriter::PIPE) {}
+};
+
+/*
+List students straight from the files (BIN_FILE or DB_FILE, with the change
+log applied on top) without loading the roster into a StudentStore, so the
+first row comes out after reading one record, however big the database is.
+Returns the number of rows written.
+*/
+long streamStudentList(const ListOptions& options, ostream& out);
+
+/*
+===============================================================================
+CLASS DEFINITION: Metrics
+===============================================================================
+Built-in counters and latency histograms for the hot paths, so we can see
+where the time goes without a profiler:
+    load    loadSnapshot() (text or binary), per call
+    parse   parseRecordLine() and splitRecords(), per line
+    save    saveAllStudentsToFile() / saveBinarySnapshot(), per file
+    lookup  StudentStore::findByDestination(), per query
+    upsert  upsertStudent() including the change log append, per call
+plus records and bytes read and written.
+Keeping the overhead low:
+- Counters are relaxed atomics (the server updates them from many threads).
+- Each histogram has one bucket per power of two nanoseconds, so recording
+  a time is a few adds and no allocation.
+- Reading the clock costs about 40 ns on our test machine, most of a
+  lookup, so frequent operations only time one call in STAT_SAMPLE_*
+  (parse 64, lookup 256, upsert 4). Calls are counted on the calling
+  thread and added to the shared counter by each timed call.
+The "stats" command, menu option 5 and the server's STATS request print
+them with report().
+*/
+enum StatOp { STAT_LOAD, STAT_PARSE, STAT_SAVE, STAT_LOOKUP, STAT_UPSERT, STAT_OP_COUNT };
+
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 48; // 1 ns .. about 39 hours
+
+    LatencyHistogram() { reset(); }
+    void record(uint64_t ns);
+    void reset();
+
+    uint64_t count() const; // Times recorded
+    double averageUs() const;
+    double percentileUs(double p) const; // Upper edge of the bucket holding percentile p (0..1)
+    double maxUs() const { return maxNs.load(memory_order_relaxed) / 1000.0; }
+
+private:
+    atomic<uint64_t> buckets[BUCKETS]; // buckets[b]: times in [2^b, 2^(b+1)) ns
+    atomic<uint64_t> totalNs;
+    atomic<uint64_t> maxNs;
+};
+
+class Metrics {
+public:
+    Metrics() : enabled(true) { reset(); }
+
+    bool enabled; // false = record nothing (used to measure the overhead)
+
+    void count(StatOp op, unsigned n) { calls[op].fetch_add(n, memory_order_relaxed); }
+    void addRead(uint64_t records, uint64_t bytes);
+    void addWritten(uint64_t records, uint64_t bytes);
+    LatencyHistogram& latency(StatOp op) { return histograms[op]; }
+
+    void report(ostream& out); // Human-readable table
+    void reset();
+
+private:
+    LatencyHistogram histograms[STAT_OP_COUNT];
+    atomic<uint64_t> calls[STAT_OP_COUNT];
+    atomic<uint64_t> recordsRead, recordsWritten, bytesRead, bytesWritten;
+};
+
+/*
+Times one operation from construction to destruction, e.g.
+    StatTimer timer(STAT_SAVE);
+Only one call in 'sampleEvery' (a power of two) reads the clock: the first,
+then every sampleEvery-th.
+*/
+class StatTimer {
+public:
+    explicit StatTimer(StatOp op, unsigned sampleEvery = 1);
+    ~StatTimer();
+
+    // Add this thread's not-yet-counted calls to METRICS (done before a report)
+    static void flushThread();
+
+private:
+    StatOp op;
+    bool timing;
+    chrono::steady_clock::time_point start;
+
+    // Per thread: calls so far, and calls not yet added to METRICS
+    static thread_local unsigned calls[STAT_OP_COUNT];
+    static thread_local unsigned pending[STAT_OP_COUNT];
+};
+
+/*
+===============================================================================
+FUNCTION PROTOTYPES (Forward Declarations)
+===============================================================================
+These tell the compiler: "These functions exist below, trust me!"
+It's like a table of contents for your program.
+*/
+int runCommandLine(int argc, char* argv[]);               // Non-interactive mode: run one command and exit
+int runIndexBenchmark();                                  // Compare destination index vs linear scan
+int runListBenchmark();                                   // Time-to-first-row and full listing, streamed vs loaded
+int runExpiryBenchmark();                                 // Memory under a continuous stream of registrations
+int runStatsBenchmark();                                  // Hot paths with Metrics on vs off
+int commandList(int argc, char* argv[]);                  // "list": streamed, paginated, filtered listing
+void parseRecordLine(const string& line, StudentForm& s); // Split a DB_FILE line (times optional) into s
+int runProximityBenchmark();                              // Time nearest-partner queries at 100k students
+int runGroupBenchmark();                                  // Time batch ride group formation at 10k / 100k
+int runSearchBenchmark();                                 // Time autocomplete / fuzzy search at 1M students
+int runServer(const char* socketPath);                    // "serve": multi-client daemon on a local socket
+int runLoadGenerator(const char* socketPath, int threads, int requests, int writePercent); // "loadgen"
+void loadPlaces();                                        // Read PLACES_FILE into CAMPUS_PLACES
+bool upsertStudent(StudentStore& store, ChangeLog& changeLog, const StudentForm& s); // Add or update + log it
+bool isBinarySnapshotCurrent();                           // BIN_FILE exists and is at least as new as DB_FILE
+void generateSyntheticStudents(StudentStore& store, int count, int destinations, unsigned seed); // Fill store with fake students
+int runGenerateCommand(int argc, char* argv[]);           // "generate": write a synthetic roster file
+int runBenchmarkSuite(int argc, char* argv[]);            // "bench": time every operation, machine-readable
+void registerStudent(StudentStore& store, ChangeLog& changeLog); // Register new student or update existing
+void findRidePartners(const StudentStore& store);         // Search for students going to same destination
+void viewAllStudents(const StudentStore& store);          // Display all registered students
+void clearAllData(StudentStore& store, ChangeLog& changeLog);    // Delete all student records
+void showMenu();                                          // Display menu options
+void ensureFileExists();                                  // Create database file if it doesn't exist
+int loadStudentsFromFile(StudentStore& store);            // Load students from file into the store
+int loadSnapshot(StudentStore& store);                    // Load the shards, BIN_FILE if current, else DB_FILE
+int convertToBinary();                                    // "convert" command: write BIN_FILE
+int shardDatabase(int shardCount);                        // "shard" command: split into shard files
+int unshardDatabase();                                    // "unshard" command: back to one DB_FILE
+int runShardBenchmark();                                  // Sharded vs single-file load, find and save
+int runParseBenchmark();                                  // Line splitting speed: old vs SIMD, 1-8 threads
+int runLoadBenchmark();                                   // Compare text vs binary cold start
+void saveAllStudentsToFile(const StudentStore& store);    // Save students from the store to file
+
+// Global constant: The name of our database file
+// Using const means this value can never be changed
+const char* DB_FILE = "ride_share_data.txt";
+
+/*
+Optional binary snapshot. It only exists after running "./ride_share convert";
+from then on compaction keeps it up to date, and startup prefers it whenever
+it is at least as new as DB_FILE.
+*/
+const char* BIN_FILE = "ride_share_data.bin";
+const uint32_t BINARY_FORMAT_VERSION = 2; // 2: records carry registration / departure times
+
+/*
+Optional sharded layout (see ShardManifest). Shard files are named
+SHARD_FILE_PREFIX + two-digit index + ".txt"; MAX_SHARD_COUNT keeps the
+number of open files and manifest lines reasonable.
+*/
+const char* MANIFEST_FILE = "ride_share_data.manifest";
+const char* SHARD_FILE_PREFIX = "ride_share_data.shard-";
+const int DEFAULT_SHARD_COUNT = 16;
+const int MAX_SHARD_COUNT = 256;
+
+// Optional list of extra named places with coordinates (Name|x|y)
+const char* PLACES_FILE = "ride_share_places.txt";
+
+/*
+Proximity matching settings:
+- PROXIMITY_CELL_KM: width of one grid cell in the ProximityIndex
+- NEARBY_DESTINATION_KM: destinations this close count as "the same trip"
+- NEAREST_PARTNERS: how many partners to show, closest first
+*/
+const double PROXIMITY_CELL_KM = 1.0;
+const double NEARBY_DESTINATION_KM = 1.5;
+const int NEAREST_PARTNERS = 10;
+
+// Places used by the synthetic benchmark rosters and the load generator
+const char* const BENCH_DESTINATIONS[] = { "Saddar", "Cantt", "Hayatabad", "University Town", "Board Bazaar",
+                                           "Tehkal", "Gulbahar", "Ring Road", "Karkhano", "Peshawar Mor" };
+const char* const BENCH_LOCATIONS[] = { "Library", "Cafe", "Main Gate", "Hostel", "Admin Block", "Sports Complex",
+                                        "Mosque", "Auditorium", "Saddar", "Tehkal", "Hayatabad", "Cantt" };
+const int BENCH_DESTINATION_COUNT = sizeof(BENCH_DESTINATIONS) / sizeof(BENCH_DESTINATIONS[0]);
+const int BENCH_LOCATION_COUNT = sizeof(BENCH_LOCATIONS) / sizeof(BENCH_LOCATIONS[0]);
+const int BENCH_SPOTS_PER_LOCATION = 20;
+
+// Default Unix-domain socket used by "serve" and "loadgen"
+const char* SERVER_SOCKET = "ride_share.sock";
+
+// Default number of seats per vehicle when forming ride groups
+const int DEFAULT_VEHICLE_CAPACITY = 4;
+
+// Size of one StringArena block (names longer than a quarter of this get their own)
+const size_t NAME_ARENA_BLOCK = 64 * 1024;
+
+/*
+Departure windows:
+- DEFAULT_DEPARTURE_WINDOW_MIN: how long a registration stays open when no
+  window is given (also used for old records without times)
+- EXPIRY_BUCKET_SECONDS: width of one expiry bucket in the StudentStore
+*/
+const int DEFAULT_DEPARTURE_WINDOW_MIN = 60;
+const uint32_t EXPIRY_BUCKET_SECONDS = 300;
+
+/*
+Loading (see RecordLoader):
+- RECORD_CHUNK_BYTES: how much of a file is read and split at a time
+- MAX_FIELD_BYTES: longest name, destination or location accepted; lines
+  with a longer one are skipped as damaged
+*/
+const size_t RECORD_CHUNK_BYTES = 1024 * 1024;
+const size_t MAX_FIELD_BYTES = 1024;
+
+// Listing: RowWriter buffer size, and rows per page in the interactive menu
+const size_t LIST_BUFFER_BYTES = 64 * 1024;
+const int LIST_PAGE_SIZE = 20;
+
+// The one place directory shared by the whole program
+PlaceDirectory CAMPUS_PLACES;
+
+// Counters and latency histograms for the whole program (see Metrics)
+Metrics METRICS;
+const unsigned STAT_SAMPLE_PARSE = 64;   // Time 1 in 64 parsed lines
+const unsigned STAT_SAMPLE_LOOKUP = 256; // Time 1 in 256 destination lookups
+const unsigned STAT_SAMPLE_UPSERT = 4;   // Time 1 in 4 registrations
+
+// Append-only change log replayed on top of DB_FILE at startup
+const char* LOG_FILE = "ride_share_data.log";
+
+/*
+Compaction threshold: the log is folded into DB_FILE once it has at least
+LOG_COMPACT_MIN_ENTRIES entries AND at least a quarter as many entries as
+there are students. Scaling with the roster keeps the cost of rewriting the
+snapshot spread thinly over many cheap appends.
+*/
+const int LOG_COMPACT_MIN_ENTRIES = 1000;
+
+/*
+===============================================================================
+MAIN FUNCTION - Program Entry Point
+===============================================================================
+This is where the program ALWAYS starts executing.
+Every C++ program must have exactly one main() function.
+*/
+int main(int argc, char* argv[]) {
+    /*
+    Command-line mode: "./ride_share <command> ..." runs one command for
+    scripts and bulk jobs, then exits (see runCommandLine()).
+    With no arguments we fall through to the interactive menu.
+    */
+    if (argc >= 2) {
+        return runCommandLine(argc, argv);
+    }
+
+    // Step 1: Make sure our database file exists before we start
+    ensureFileExists();
+    loadPlaces(); // Coordinates must be known before students are indexed
+
+    /*
+    Step 2: Load the whole roster into memory ONCE.
+    Every menu action below works on this store instead of re-reading the file.
+    We also time the load so slow startups on big rosters are easy to spot.
+    */
+    StudentStore store;
+    ChangeLog changeLog(LOG_FILE);
+    chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+    int loaded = loadSnapshot(store);
+    int replayed = changeLog.replay(store); // Recover changes made after the last snapshot
+    int expired = store.expire(nowSeconds()); // Drop rides whose departure window is over
+    double loadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+    
+    // Variable to store user's menu choice (1-6)
+    int choice;
+    
+    // Welcome message
+    cout << "*** Welcome to University Ride Share System ***\n";
+    cout << "Data is permanently stored in: " << (isShardedLayout() ? MANIFEST_FILE : DB_FILE) << "\n";
+    cout << "[System] Loaded " << loaded << " students in " << loadMs << " ms.\n";
+    if (expired > 0) {
+        cout << "[System] " << expired << " ride requests have expired and were removed.\n";
+    }
+    if (replayed > 0) {
+        cout << "[System] Recovered " << replayed << " recent changes from " << LOG_FILE << ".\n";
+    }
+    
+    /*
+    Main Program Loop - Keeps running until user chooses to exit
+    while(true) creates an infinite loop that only stops when we use 'break'
+    */
+    while (true) {
+        // Display the menu options to user
+        showMenu();
+        
+        // Ask user to enter their choice
+        cout << "\nEnter your choice: ";
+        
+        /*
+        Input Validation: Check if user entered a valid number
+        !(cin >> choice) returns true if input FAILS (e.g., user types letters)
+        */
+        if (!(cin >> choice)) {
+            cout << "Invalid input. Please enter a number.\n";
+            cin.clear();              // Clear the error flag on cin
+            cin.ignore(1000, '\n');   // Discard invalid input up to 1000 chars or newline
+            continue;                 // Skip rest of loop, go back to start (show menu again)
+        }
+        
+        /*
+        Clear the newline character left in buffer after reading the number
+        When user types "3" and presses Enter, cin >> choice reads "3" but leaves "\n"
+        cin.ignore() removes that leftover newline so it doesn't interfere with getline() later
+        */
+        cin.ignore();
+
+        // Requests whose departure window ended while the menu was open go now
+        store.expire(nowSeconds());
+
+        /*
+        Menu Selection Logic
+        Based on what number user entered, call the appropriate function
+        */
+        if (choice == 1) {
+            registerStudent(store, changeLog); // Option 1: Register or update student info
+        } 
+        else if (choice == 2) {
+            findRidePartners(store);   // Option 2: Search for ride partners
+        } 
+        else if (choice == 3) {
+            viewAllStudents(store);    // Option 3: View all registered students
+        } 
+        else if (choice == 4) {
+            clearAllData(store, changeLog);    // Option 4: Delete all data
+        } 
+        else if (choice == 5) {
+            // Option 5: Where the time went in this session
+            cout << "\n--- STATISTICS ---\n";
+            METRICS.report(cout);
+        }
+        else if (choice == 6) {
+            // Fold any pending log entries into DB_FILE so the next start is quick
+            if (changeLog.entries() > 0) compactDatabase(store, changeLog);
+            cout << "Exiting application. Goodbye!\n";
+            break;                // Exit the while loop (ends program)
+        } 
+        else {
+            cout << "Invalid choice. Try again.\n";
+        }
+        
+        // Print a separator line for better readability
+        cout << "\n----------------------------------------\n";
+    }
+
+    // Return 0 to operating system indicating successful program completion
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: showMenu()
+===============================================================================
+Purpose: Display the menu options to the user
+Parameters: None
+Returns: void (nothing)
+*/
+void showMenu() {
+    cout << "\n=== UNIVERSITY RIDE SHARE SYSTEM ===\n";
+    cout << "1. Register / Update My Location\n";
+    cout << "2. Find Students Going to My Destination\n";
+    cout << "3. View All Registered Students\n";
+    cout << "4. Clear All Data\n";
+    cout << "5. Show Statistics\n";
+    cout << "6. Exit\n";
+}
+
+/*
+===============================================================================
+FUNCTION: ensureFileExists()
+===============================================================================
+Purpose: Create the database file if it doesn't exist
+Why needed: Program needs this file to store student data permanently
+Parameters: None
+Returns: void (nothing)
+*/
+void ensureFileExists() {
+    // A sharded database keeps its students in the shard files instead
+    if (isShardedLayout()) return;
+
+    // Try to open file for reading (input file stream)
+    ifstream testFile(DB_FILE);
+    
+    // If file doesn't exist or can't be opened
+    if (!testFile) {
+        // Create the file by opening it in output mode
+        // Opening with ofstream automatically creates the file if it doesn't exist
+        ofstream createFile(DB_FILE);
+        
+        if (createFile) {
+            createFile.close(); // Close the file (good practice)
+            cout << "[System] Database file created successfully.\n";
+        } 
+        else {
+            // Error: Can't create file (maybe no write permissions)
+            cout << "[ERROR] Cannot create database file. Check folder permissions!\n";
+            cout << "[INFO] Trying alternative location...\n";
+            // Could try a different path here (e.g., user's home directory)
+        }
+    } 
+    else {
+        // File already exists, just close it
+        testFile.close();
+    }
+}
+
+/*
+===============================================================================
+FUNCTIONS: NameIndex
+===============================================================================
+Names are hashed with FNV-1a over their lower-cased letters, so "Ali" and
+"ALI" land on the same slot. Deleting uses "backward shift": the entries
+after the hole that belong earlier are moved back into it, so lookups never
+have to skip over deleted slots.
+*/
+static uint32_t nameHash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const char* c = name; *c; c++) {
+        h ^= (uint32_t)tolower((unsigned char)*c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int NameIndex::find(const char* name, const vector<Student>& students) const {
+    if (slots.empty()) return -1;
+    uint32_t h = nameHash(name);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; slots[i].pos >= 0; i = (i + 1) & mask) {
+        if (slots[i].hash == h && strcasecmp(students[slots[i].pos].name, name) == 0) {
+            return slots[i].pos;
+        }
+    }
+    return -1;
+}
+
+void NameIndex::insert(int pos, const vector<Student>& students) {
+    if ((size_t)(used + 1) * 2 > slots.size()) grow(slots.empty() ? 16 : slots.size() * 2);
+    uint32_t h = nameHash(students[pos].name);
+    size_t mask = slots.size() - 1;
+    size_t i = h & mask;
+    while (slots[i].pos >= 0) i = (i + 1) & mask;
+    slots[i].hash = h;
+    slots[i].pos = pos;
+    used++;
+}
+
+int NameIndex::slotOf(int pos, const vector<Student>& students) const {
+    size_t mask = slots.size() - 1;
+    size_t i = nameHash(students[pos].name) & mask;
+    while (slots[i].pos != pos) i = (i + 1) & mask; // pos is always in the table
+    return (int)i;
+}
+
+void NameIndex::erase(int pos, const vector<Student>& students) {
+    size_t mask = slots.size() - 1;
+    size_t hole = (size_t)slotOf(pos, students);
+    for (size_t j = (hole + 1) & mask; slots[j].pos >= 0; j = (j + 1) & mask) {
+        size_t home = slots[j].hash & mask; // Where slot j's entry would like to be
+        // Leave it if its home is cyclically in (hole, j]; otherwise fill the hole with it
+        bool stays = (hole < j) ? (home > hole && home <= j) : (home > hole || home <= j);
+        if (!stays) {
+            slots[hole] = slots[j];
+            hole = j;
+        }
+    }
+    slots[hole].pos = -1;
+    used--;
+}
+
+void NameIndex::move(int from, int to, const vector<Student>& students) {
+    // The record is already at 'to', and its name (and so its hash) is unchanged
+    size_t mask = slots.size() - 1;
+    size_t i = nameHash(students[to].name) & mask;
+    while (slots[i].pos != from) i = (i + 1) & mask;
+    slots[i].pos = to;
+}
+
+void NameIndex::reserve(int n) {
+    size_t size = slots.empty() ? 16 : slots.size();
+    while (size < (size_t)n * 2) size *= 2;
+    if (size > slots.size()) grow(size);
+}
+
+void NameIndex::grow(size_t size) {
+    vector<Slot> old;
+    old.swap(slots);
+    Slot empty = { 0, -1 };
+    slots.assign(size, empty);
+    size_t mask = size - 1;
+    for (size_t s = 0; s < old.size(); s++) {
+        if (old[s].pos < 0) continue;
+        size_t i = old[s].hash & mask; // The hash is kept, so names are not read again
+        while (slots[i].pos >= 0) i = (i + 1) & mask;
+        slots[i] = old[s];
+    }
+}
+
+void NameIndex::clear() {
+    vector<Slot>().swap(slots);
+    used = 0;
+}
+
+/*
+===============================================================================
+FUNCTION: normalizeKey()
+===============================================================================
+Purpose: Build the case-insensitive key used by the destination index
+Parameters:
+  - text: Place name as typed by the user
+Returns: string - The same text in lower case
+*/
+string normalizeKey(const char* text) {
+    string key(text);
+    for (size_t i = 0; i < key.size(); i++) {
+        key[i] = (char)tolower((unsigned char)key[i]);
+    }
+    return key;
+}
+
+/*
+===============================================================================
+FUNCTIONS: windowsOverlap() / nowSeconds() / setDepartureWindow() / viewOf()
+===============================================================================
+Two students can share a ride if one can leave before the other's window
+closes, and the other before the first one's closes.
+*/
+bool windowsOverlap(uint32_t fromA, uint32_t untilA, uint32_t fromB, uint32_t untilB) {
+    return fromA <= untilB && fromB <= untilA;
+}
+
+uint32_t nowSeconds() {
+    return (uint32_t)time(NULL);
+}
+
+void setDepartureWindow(StudentForm& s, int leaveInMin, int windowMin) {
+    s.registeredAt = nowSeconds();
+    s.departFrom = s.registeredAt + (uint32_t)max(0, leaveInMin) * 60;
+    s.departUntil = s.departFrom + (uint32_t)max(1, windowMin) * 60;
+}
+
+StudentView viewOf(const StudentForm& s) {
+    StudentView v;
+    v.name = s.name.c_str();
+    v.destination = s.destination.c_str();
+    v.currentLocation = s.currentLocation.c_str();
+    v.registeredAt = s.registeredAt;
+    v.departFrom = s.departFrom;
+    v.departUntil = s.departUntil;
+    return v;
+}
+
+/*
+===============================================================================
+FUNCTIONS: StudentStore index maintenance
+===============================================================================
+Each destination key maps to a list of positions kept in ascending order,
+so results come out in the same order as the file.
+*/
+void StudentStore::indexDestination(int i) {
+    uint32_t key = destinationKey(i);
+    if (key >= destIndex.size()) destIndex.resize(key + 1);
+    markChanged(key);
+    vector<int>& ids = destIndex[key];
+    ids.insert(lower_bound(ids.begin(), ids.end(), i), i);
+}
+
+void StudentStore::unindexDestination(int i) {
+    markChanged(destinationKey(i));
+    vector<int>& ids = destIndex[destinationKey(i)];
+    vector<int>::iterator pos = lower_bound(ids.begin(), ids.end(), i);
+    if (pos != ids.end() && *pos == i) ids.erase(pos);
+}
+
+void StudentStore::indexProximity(int i) {
+    Point where;
+    if (CAMPUS_PLACES.lookup(placeNames.text(students[i].currentLocation), where)) {
+        nearby.insert(i, placeNames.keyText(destinationKey(i)), where);
+    }
+}
+
+void StudentStore::unindexProximity(int i) {
+    Point where;
+    if (CAMPUS_PLACES.lookup(placeNames.text(students[i].currentLocation), where)) {
+        nearby.erase(i, placeNames.keyText(destinationKey(i)), where);
+    }
+}
+
+/*
+Times that were not given default to: registered now, leaving from then,
+for DEFAULT_DEPARTURE_WINDOW_MIN minutes.
+*/
+static void copyTimes(const StudentView& s, Student& record) {
+    record.registeredAt = s.registeredAt ? s.registeredAt : nowSeconds();
+    record.departFrom = s.departFrom ? s.departFrom : record.registeredAt;
+    record.departUntil = s.departUntil ? s.departUntil
+                                       : record.departFrom + DEFAULT_DEPARTURE_WINDOW_MIN * 60;
+}
+
+void StudentStore::add(const StudentForm& s) {
+    add(viewOf(s));
+}
+
+void StudentStore::add(const StudentView& s) {
+    Student record;
+    record.name = names.add(s.name);
+    record.destination = placeNames.intern(s.destination);
+    record.currentLocation = placeNames.intern(s.currentLocation);
+    copyTimes(s, record);
+    students.push_back(record);
+    byName.insert(size() - 1, students);
+    indexRecord(size() - 1);
+}
+
+void StudentStore::update(int i, const StudentForm& s) {
+    uint32_t dest = placeNames.intern(s.destination.c_str());
+    uint32_t location = placeNames.intern(s.currentLocation.c_str());
+    uint32_t oldUntil = students[i].departUntil;
+    copyTimes(viewOf(s), students[i]);
+
+    // Same spellings as before: only the times changed (two integer compares)
+    if (dest == students[i].destination && location == students[i].currentLocation) {
+        if (students[i].departUntil != oldUntil) indexExpiry(i);
+        markChanged(destinationKey(i)); // The times still have to be saved
+        return;
+    }
+
+    unindexRecord(i);  // Old destination and location no longer apply
+    students[i].destination = dest;
+    students[i].currentLocation = location;
+    indexRecord(i);    // File it under the new ones
+}
+
+/*
+Expiry buckets hold positions, but positions change when records move or
+are updated. Instead of finding and fixing old entries, a record is simply
+filed again, and expire() checks each entry against the record that is at
+that position NOW: it only ever removes students whose window really ended.
+Stale entries disappear when their bucket expires.
+*/
+void StudentStore::indexExpiry(int i) {
+    expiry[students[i].departUntil / EXPIRY_BUCKET_SECONDS].push_back(i);
+}
+
+int StudentStore::expire(uint32_t now) {
+    int removed = 0;
+    while (!expiry.empty()) {
+        map<uint32_t, vector<int> >::iterator oldest = expiry.begin();
+        // Only buckets whose whole time span is over
+        if ((uint64_t)(oldest->first + 1) * EXPIRY_BUCKET_SECONDS > now) break;
+
+        vector<int> ids;
+        ids.swap(oldest->second);
+        expiry.erase(oldest);
+
+        /*
+        Highest positions first: remove() only ever moves the LAST record,
+        so the lower positions still to be checked stay where they are.
+        (The moved record is filed again under its own bucket.)
+        */
+        sort(ids.begin(), ids.end());
+        for (size_t k = ids.size(); k-- > 0; ) {
+            int i = ids[k];
+            if (k + 1 < ids.size() && ids[k + 1] == i) continue; // Filed twice
+            if (i < size() && students[i].departUntil < now) {
+                remove(i);
+                removed++;
+            }
+        }
+    }
+    return removed;
+}
+
+void StudentStore::indexPlaces(int i, int delta) {
+    places.add(placeNames.text(students[i].destination), PlaceSearchIndex::DESTINATION, delta);
+    places.add(placeNames.text(students[i].currentLocation), PlaceSearchIndex::LOCATION, delta);
+}
+
+bool StudentStore::findNearest(const char* destination, const char* fromLocation, int k,
+                               double radiusKm, vector<NearbyMatch>& out) const {
+    out.clear();
+    Point from;
+    if (!CAMPUS_PLACES.lookup(fromLocation, from)) return false;
+    nearby.nearest(normalizeKey(destination), from, k, radiusKm, out);
+    return true;
+}
+
+const vector<int>* StudentStore::findByDestination(const char* destination) const {
+    StatTimer timer(STAT_LOOKUP, STAT_SAMPLE_LOOKUP);
+    int key = placeNames.findKey(destination);
+    if (key < 0 || key >= (int)destIndex.size() || destIndex[key].empty()) return NULL;
+    return &destIndex[key];
+}
+
+void StudentStore::remove(int i) {
+    int last = size() - 1;
+    unindexRecord(i);
+    byName.erase(i, students);
+    names.release(students[i].name);
+    if (i != last) {
+        // Fill the gap with the last record so nothing else has to shift
+        unindexRecord(last);
+        students[i] = students[last];
+        byName.move(last, i, students);
+        students.pop_back();
+        indexRecord(i);
+    }
+    else {
+        students.pop_back();
+    }
+
+    // Once most of the arena is dead names, copy the live ones to a fresh one
+    if (names.bytesWasted() > NAME_ARENA_BLOCK && names.bytesWasted() * 2 > names.bytesUsed()) {
+        repackNames();
+    }
+}
+
+void StudentStore::repackNames() {
+    StringArena fresh;
+    for (size_t i = 0; i < students.size(); i++) {
+        students[i].name = fresh.add(students[i].name);
+    }
+    names.swap(fresh); // The old blocks are freed when 'fresh' goes away
+}
+
+const vector<int>& StudentStore::studentsGoingTo(uint32_t key) const {
+    static const vector<int> nobody;
+    return key < destIndex.size() ? destIndex[key] : nobody;
+}
+
+void StudentStore::markChanged(uint32_t key) {
+    if (key >= changedKeys.size()) changedKeys.resize(key + 1, 0);
+    changedKeys[key] = 1;
+}
+
+void StudentStore::destinationLists(vector<const vector<int>*>& out) const {
+    out.clear();
+    for (size_t key = 0; key < destIndex.size(); key++) {
+        if (!destIndex[key].empty()) out.push_back(&destIndex[key]);
+    }
+}
+
+void StudentStore::clear() {
+    vector<Student>().swap(students);
+    vector<vector<int> >().swap(destIndex);
+    placeNames.clear();
+    names.clear();
+    byName.clear();
+    expiry.clear();
+    nearby.clear();
+    places.clear();
+    vector<char>().swap(changedKeys);
+    everythingChanged = true; // Every saved student is gone
+}
+
+size_t StudentStore::memoryBytes() const {
+    size_t bytes = students.capacity() * sizeof(Student) + names.memoryBytes() + placeNames.memoryBytes()
+                 + byName.memoryBytes();
+    for (size_t key = 0; key < destIndex.size(); key++) {
+        bytes += destIndex[key].capacity() * sizeof(int);
+    }
+    for (map<uint32_t, vector<int> >::const_iterator it = expiry.begin(); it != expiry.end(); ++it) {
+        bytes += 48 + it->second.capacity() * sizeof(int); // Tree node + list
+    }
+    return bytes;
+}
+
+/*
+===============================================================================
+FUNCTIONS: PlacePool
+===============================================================================
+*/
+uint32_t PlacePool::intern(const char* text) {
+    unordered_map<string, uint32_t>::const_iterator it = ids.find(text);
+    if (it != ids.end()) return it->second; // Seen this exact spelling before
+
+    // New spelling: find (or create) the key it shares with other spellings
+    string folded = normalizeKey(text);
+    uint32_t key;
+    unordered_map<string, uint32_t>::const_iterator k = keyIds.find(folded);
+    if (k != keyIds.end()) {
+        key = k->second;
+    }
+    else {
+        key = (uint32_t)keys.size();
+        keys.push_back(folded);
+        keyIds[folded] = key;
+    }
+
+    uint32_t id = (uint32_t)spellings.size();
+    spellings.push_back(text);
+    keyOf.push_back(key);
+    ids[text] = id;
+    return id;
+}
+
+int PlacePool::findKey(const char* text) const {
+    // Most lookups use a spelling someone registered with: no lower-casing needed
+    unordered_map<string, uint32_t>::const_iterator it = ids.find(text);
+    if (it != ids.end()) return (int)keyOf[it->second];
+
+    unordered_map<string, uint32_t>::const_iterator k = keyIds.find(normalizeKey(text));
+    return k == keyIds.end() ? -1 : (int)k->second;
+}
+
+size_t PlacePool::memoryBytes() const {
+    size_t bytes = keyOf.capacity() * sizeof(uint32_t);
+    for (size_t i = 0; i < spellings.size(); i++) bytes += 2 * (sizeof(string) + spellings[i].size() + 16);
+    for (size_t i = 0; i < keys.size(); i++) bytes += 2 * (sizeof(string) + keys[i].size() + 16);
+    return bytes;
+}
+
+void PlacePool::clear() {
+    spellings.clear();
+    keyOf.clear();
+    ids.clear();
+    keys.clear();
+    keyIds.clear();
+}
+
+/*
+===============================================================================
+FUNCTIONS: StringArena
+===============================================================================
+*/
+const char* StringArena::add(const char* text) {
+    size_t length = strlen(text) + 1;
+    if (length > NAME_ARENA_BLOCK / 4) {
+        // Very long string: give it a block of its own, keep filling the current one
+        blocks.push_back(unique_ptr<char[]>(new char[length]));
+        char* own = blocks.back().get();
+        memcpy(own, text, length);
+        used += length;
+        reserved += length;
+        return own;
+    }
+    if (length > blockFree) {
+        blocks.push_back(unique_ptr<char[]>(new char[NAME_ARENA_BLOCK]));
+        cursor = blocks.back().get();
+        blockFree = NAME_ARENA_BLOCK;
+        reserved += NAME_ARENA_BLOCK;
+    }
+    char* copy = cursor;
+    memcpy(copy, text, length);
+    cursor += length;
+    blockFree -= length;
+    used += length;
+    return copy;
+}
+
+void StringArena::swap(StringArena& other) {
+    blocks.swap(other.blocks);
+    std::swap(cursor, other.cursor);
+    std::swap(blockFree, other.blockFree);
+    std::swap(used, other.used);
+    std::swap(wasted, other.wasted);
+    std::swap(reserved, other.reserved);
+}
+
+void StringArena::clear() {
+    vector<unique_ptr<char[]> >().swap(blocks);
+    cursor = NULL;
+    blockFree = used = wasted = reserved = 0;
+}
+
+/*
+===============================================================================
+FUNCTIONS: LatencyHistogram / Metrics / StatTimer
+===============================================================================
+*/
+void LatencyHistogram::record(uint64_t ns) {
+    // Bucket = floor(log2(ns)): one instruction with GCC / Clang
+#if defined(__GNUC__)
+    int b = (ns > 1) ? 63 - __builtin_clzll(ns) : 0;
+#else
+    int b = 0;
+    for (uint64_t v = ns; v > 1; v >>= 1) b++;
+#endif
+    buckets[min(b, BUCKETS - 1)].fetch_add(1, memory_order_relaxed);
+    totalNs.fetch_add(ns, memory_order_relaxed);
+    uint64_t seen = maxNs.load(memory_order_relaxed); // Usually smaller than the max: no write
+    while (ns > seen && !maxNs.compare_exchange_weak(seen, ns, memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() {
+    for (int b = 0; b < BUCKETS; b++) buckets[b].store(0, memory_order_relaxed);
+    totalNs.store(0, memory_order_relaxed);
+    maxNs.store(0, memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::count() const {
+    uint64_t n = 0;
+    for (int b = 0; b < BUCKETS; b++) n += buckets[b].load(memory_order_relaxed);
+    return n;
+}
+
+double LatencyHistogram::averageUs() const {
+    uint64_t n = count();
+    return n ? totalNs.load(memory_order_relaxed) / 1000.0 / n : 0;
+}
+
+double LatencyHistogram::percentileUs(double p) const {
+    uint64_t n = count();
+    if (n == 0) return 0;
+    uint64_t wanted = (uint64_t)ceil(p * n), seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b].load(memory_order_relaxed);
+        if (seen >= wanted && seen > 0) {
+            return min((double)(2ULL << b), (double)maxNs.load(memory_order_relaxed)) / 1000.0;
+        }
+    }
+    return maxUs();
+}
+
+void Metrics::addRead(uint64_t records, uint64_t bytes) {
+    if (!enabled) return;
+    recordsRead.fetch_add(records, memory_order_relaxed);
+    bytesRead.fetch_add(bytes, memory_order_relaxed);
+}
+
+void Metrics::addWritten(uint64_t records, uint64_t bytes) {
+    if (!enabled) return;
+    recordsWritten.fetch_add(records, memory_order_relaxed);
+    bytesWritten.fetch_add(bytes, memory_order_relaxed);
+}
+
+void Metrics::reset() {
+    for (int op = 0; op < STAT_OP_COUNT; op++) {
+        histograms[op].reset();
+        calls[op].store(0, memory_order_relaxed);
+    }
+    recordsRead.store(0, memory_order_relaxed);
+    recordsWritten.store(0, memory_order_relaxed);
+    bytesRead.store(0, memory_order_relaxed);
+    bytesWritten.store(0, memory_order_relaxed);
+}
+
+/*
+One line per operation. "timed" is how many calls were actually measured
+(one in STAT_SAMPLE_* for the sampled operations). Percentiles are the upper
+edge of their power-of-two bucket, so they can read up to 2x high.
+*/
+void Metrics::report(ostream& out) {
+    StatTimer::flushThread(); // Other threads' last few sampled calls may still be missing
+    static const char* const names[STAT_OP_COUNT] = { "load", "parse", "save", "lookup", "upsert" };
+    char line[160];
+    snprintf(line, sizeof(line), "%-8s %12s %10s %10s %10s %10s %12s\n",
+             "op", "calls", "timed", "avg_us", "p50_us", "p99_us", "max_us");
+    out << line;
+    for (int op = 0; op < STAT_OP_COUNT; op++) {
+        const LatencyHistogram& h = histograms[op];
+        snprintf(line, sizeof(line), "%-8s %12llu %10llu %10.3f %10.3f %10.3f %12.3f\n", names[op],
+                 (unsigned long long)calls[op].load(memory_order_relaxed), (unsigned long long)h.count(),
+                 h.averageUs(), h.percentileUs(0.50), h.percentileUs(0.99), h.maxUs());
+        out << line;
+    }
+    out << "records_read    " << recordsRead.load(memory_order_relaxed) << "\n"
+        << "records_written " << recordsWritten.load(memory_order_relaxed) << "\n"
+        << "bytes_read      " << bytesRead.load(memory_order_relaxed) << "\n"
+        << "bytes_written   " << bytesWritten.load(memory_order_relaxed) << "\n";
+}
+
+thread_local unsigned StatTimer::calls[STAT_OP_COUNT];
+thread_local unsigned StatTimer::pending[STAT_OP_COUNT];
+
+StatTimer::StatTimer(StatOp op, unsigned sampleEvery) : op(op), timing(false) {
+    if (!METRICS.enabled) return;
+    // Counted per thread first, so server threads do not fight over one counter
+    pending[op]++;
+    if ((calls[op]++ & (sampleEvery - 1)) != 0) return;
+
+    // The timed call adds itself and the untimed ones before it, in one go
+    METRICS.count(op, pending[op]);
+    pending[op] = 0;
+    timing = true;
+    start = chrono::steady_clock::now();
+}
+
+void StatTimer::flushThread() {
+    for (int op = 0; op < STAT_OP_COUNT; op++) {
+        if (pending[op] > 0) METRICS.count((StatOp)op, pending[op]);
+        pending[op] = 0;
+    }
+}
+
+StatTimer::~StatTimer() {
+    if (timing) {
+        METRICS.latency(op).record((uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - start).count());
+    }
+}
+
+/*
+===============================================================================
+FUNCTIONS: PlaceDirectory
+===============================================================================
+Built-in coordinates are approximate, in km from Saddar (x = east, y = north).
+Campus spots sit around the university in University Town. Use PLACES_FILE
+to add places or correct these for a different campus.
+*/
+PlaceDirectory::PlaceDirectory() {
+    static const struct { const char* name; double x, y; } builtIn[] = {
+        // City destinations
+        { "Saddar", 0.0, 0.0 },          { "Cantt", 0.8, 0.9 },
+        { "Qissa Khwani", 2.0, 1.2 },    { "Hashtnagri", 2.6, 1.9 },
+        { "Gulbahar", 3.2, 1.6 },        { "GT Road", 4.0, 0.2 },
+        { "Ring Road", 5.0, -3.0 },      { "Kohat Road", 1.2, -4.0 },
+        { "Charsadda Road", 3.0, 5.0 },  { "Warsak Road", -3.0, 4.0 },
+        { "Tehkal", -2.5, 0.6 },         { "Peshawar Mor", -3.2, -2.0 },
+        { "University Town", -4.0, 1.0 },{ "Board Bazaar", -6.0, 0.5 },
+        { "Hayatabad", -9.0, -1.0 },     { "Karkhano", -11.0, -2.0 },
+        // Campus spots (current locations)
+        { "Main Gate", -4.2, 1.3 },      { "Library", -4.6, 1.6 },
+        { "Cafe", -4.4, 1.5 },           { "Admin Block", -4.5, 1.4 },
+        { "Hostel", -4.8, 1.9 },         { "Sports Complex", -4.9, 1.2 },
+        { "Mosque", -4.5, 1.8 },         { "Auditorium", -4.3, 1.7 }
+    };
+    for (size_t i = 0; i < sizeof(builtIn) / sizeof(builtIn[0]); i++) {
+        set(builtIn[i].name, builtIn[i].x, builtIn[i].y);
+    }
+}
+
+void PlaceDirectory::set(const char* name, double x, double y) {
+    Point p = { x, y };
+    places[normalizeKey(name)] = p;
+}
+
+bool PlaceDirectory::lookup(const char* name, Point& where) const {
+    unordered_map<string, Point>::const_iterator it = places.find(normalizeKey(name));
+    if (it == places.end()) return false;
+    where = it->second;
+    return true;
+}
+
+int PlaceDirectory::loadFile(const char* path) {
+    ifstream inFile(path);
+    if (!inFile) return 0; // The file is optional
+
+    int added = 0;
+    string line;
+    while (getline(inFile, line)) {
+        size_t bar1 = line.find('|');
+        size_t bar2 = (bar1 == string::npos) ? string::npos : line.find('|', bar1 + 1);
+        if (bar2 == string::npos) continue; // Not Name|x|y
+        set(line.substr(0, bar1).c_str(),
+            atof(line.substr(bar1 + 1, bar2 - bar1 - 1).c_str()),
+            atof(line.substr(bar2 + 1).c_str()));
+        added++;
+    }
+    return added;
+}
+
+void loadPlaces() {
+    CAMPUS_PLACES.loadFile(PLACES_FILE);
+}
+
+double distanceKm(Point a, Point b) {
+    double dx = a.x - b.x, dy = a.y - b.y;
+    return sqrt(dx * dx + dy * dy);
+}
+
+/*
+===============================================================================
+FUNCTIONS: ProximityIndex
+===============================================================================
+Cells are numbered by floor(x / PROXIMITY_CELL_KM) and floor(y / ...);
+the two numbers are packed into one 64-bit key for the hash map.
+*/
+static int cellOf(double km) {
+    return (int)floor(km / PROXIMITY_CELL_KM);
+}
+
+static long long cellKey(int cx, int cy) {
+    return ((long long)cx << 32) ^ (long long)(unsigned int)cy;
+}
+
+void ProximityIndex::insert(int id, const string& destKey, Point where) {
+    unordered_map<string, DestGrid>::iterator it = grids.find(destKey);
+    int cx = cellOf(where.x), cy = cellOf(where.y);
+    if (it == grids.end()) {
+        DestGrid grid;
+        grid.hasPoint = CAMPUS_PLACES.lookup(destKey.c_str(), grid.point);
+        grid.minCx = grid.maxCx = cx;
+        grid.minCy = grid.maxCy = cy;
+        it = grids.insert(make_pair(destKey, grid)).first;
+    }
+    DestGrid& grid = it->second;
+    grid.minCx = min(grid.minCx, cx); grid.maxCx = max(grid.maxCx, cx);
+    grid.minCy = min(grid.minCy, cy); grid.maxCy = max(grid.maxCy, cy);
+
+    Entry e = { id, where };
+    grid.cells[cellKey(cx, cy)].push_back(e);
+}
+
+void ProximityIndex::erase(int id, const string& destKey, Point where) {
+    unordered_map<string, DestGrid>::iterator it = grids.find(destKey);
+    if (it == grids.end()) return;
+
+    DestGrid& grid = it->second;
+    unordered_map<long long, vector<Entry> >::iterator cell =
+        grid.cells.find(cellKey(cellOf(where.x), cellOf(where.y)));
+    if (cell == grid.cells.end()) return;
+
+    vector<Entry>& entries = cell->second;
+    for (size_t e = 0; e < entries.size(); e++) {
+        if (entries[e].id == id) {
+            entries[e] = entries.back(); // Order inside a cell does not matter
+            entries.pop_back();
+            break;
+        }
+    }
+    if (entries.empty()) grid.cells.erase(cell);
+    if (grid.cells.empty()) grids.erase(it);
+}
+
+// Used to sort matches closest first
+static bool closerMatch(const NearbyMatch& a, const NearbyMatch& b) {
+    return a.distanceKm < b.distanceKm;
+}
+
+void ProximityIndex::nearest(const string& destKey, Point from, int k, double radiusKm,
+                             vector<NearbyMatch>& out) const {
+    out.clear();
+    if (k <= 0) return;
+
+    // Step 1: Pick the grids to search - the destination itself plus
+    // any destination with coordinates within radiusKm of it
+    Point target;
+    bool haveTarget = CAMPUS_PLACES.lookup(destKey.c_str(), target);
+    vector<const DestGrid*> search;
+    for (unordered_map<string, DestGrid>::const_iterator it = grids.begin(); it != grids.end(); ++it) {
+        if (it->first == destKey ||
+            (haveTarget && it->second.hasPoint && distanceKm(target, it->second.point) <= radiusKm)) {
+            search.push_back(&it->second);
+        }
+    }
+    if (search.empty()) return;
+
+    // Step 2: How many rings we may need before every used cell is covered
+    int cx = cellOf(from.x), cy = cellOf(from.y);
+    int maxRing = 0;
+    for (size_t g = 0; g < search.size(); g++) {
+        maxRing = max(maxRing, max(max(cx - search[g]->minCx, search[g]->maxCx - cx),
+                                   max(cy - search[g]->minCy, search[g]->maxCy - cy)));
+    }
+
+    // Step 3: Walk outwards ring by ring
+    for (int r = 0; r <= maxRing; r++) {
+        for (int dx = -r; dx <= r; dx++) {
+            for (int dy = -r; dy <= r; dy++) {
+                // Only the border of the square is new in this ring
+                if (dx != -r && dx != r && dy != -r && dy != r) continue;
+                long long key = cellKey(cx + dx, cy + dy);
+                for (size_t g = 0; g < search.size(); g++) {
+                    unordered_map<long long, vector<Entry> >::const_iterator cell = search[g]->cells.find(key);
+                    if (cell == search[g]->cells.end()) continue;
+                    for (size_t e = 0; e < cell->second.size(); e++) {
+                        NearbyMatch m = { cell->second[e].id, distanceKm(from, cell->second[e].where) };
+                        out.push_back(m);
+                    }
+                }
+            }
+        }
+
+        /*
+        Anything in ring r+1 or further out is at least r cells away.
+        Once we hold k matches that are all closer than that, stop.
+        */
+        if ((int)out.size() >= k) {
+            nth_element(out.begin(), out.begin() + (k - 1), out.end(), closerMatch);
+            out.resize(k);
+            if (out[k - 1].distanceKm <= r * PROXIMITY_CELL_KM) break;
+        }
+    }
+
+    sort(out.begin(), out.end(), closerMatch);
+    if ((int)out.size() > k) out.resize(k);
+}
+
+/*
+===============================================================================
+FUNCTIONS: PlaceSearchIndex
+===============================================================================
+*/
+void PlaceSearchIndex::clear() {
+    nodes.assign(1, Node());
+}
+
+int PlaceSearchIndex::child(int node, char c) const {
+    const vector<pair<char, int> >& kids = nodes[node].children;
+    vector<pair<char, int> >::const_iterator it =
+        lower_bound(kids.begin(), kids.end(), make_pair(c, -1));
+    if (it == kids.end() || it->first != c) return -1;
+    return it->second;
+}
+
+void PlaceSearchIndex::add(const char* text, Field field, int delta) {
+    string key = normalizeKey(text);
+    if (key.empty()) return;
+
+    int node = 0;
+    for (size_t i = 0; i < key.size(); i++) {
+        int next = child(node, key[i]);
+        if (next < 0) {
+            if (delta < 0) return; // Removing something that was never added
+            next = (int)nodes.size();
+            nodes.push_back(Node());
+            vector<pair<char, int> >& kids = nodes[node].children;
+            kids.insert(lower_bound(kids.begin(), kids.end(), make_pair(key[i], -1)), make_pair(key[i], next));
+        }
+        node = next;
+    }
+    Node& end = nodes[node];
+    if (end.count[0] + end.count[1] == 0 && delta > 0) end.display = text; // First spelling seen
+    end.count[field] = max(0, end.count[field] + delta);
+}
+
+/*
+Add every place at or below 'node' that is in use for 'field', as
+(-students, node) pairs. Only numbers are gathered here; the strings are
+copied later for the few results actually returned.
+*/
+void PlaceSearchIndex::collect(int node, Field field, vector<pair<int, int> >& out) const {
+    if (nodes[node].count[field] > 0) {
+        out.push_back(make_pair(-nodes[node].count[field], node));
+    }
+    for (size_t k = 0; k < nodes[node].children.size(); k++) {
+        collect(nodes[node].children[k].second, field, out);
+    }
+}
+
+// Sort order for suggestions: fewer typos, then more students, then A-Z
+static bool betterSuggestion(const PlaceSuggestion& a, const PlaceSuggestion& b) {
+    if (a.edits != b.edits) return a.edits < b.edits;
+    if (a.students != b.students) return a.students > b.students;
+    return a.text < b.text;
+}
+
+static void keepBest(vector<PlaceSuggestion>& out, int limit) {
+    if ((int)out.size() > limit) {
+        partial_sort(out.begin(), out.begin() + limit, out.end(), betterSuggestion);
+        out.resize(limit);
+    }
+    else {
+        sort(out.begin(), out.end(), betterSuggestion);
+    }
+}
+
+void PlaceSearchIndex::complete(const char* prefix, Field field, int limit, vector<PlaceSuggestion>& out) const {
+    out.clear();
+    string key = normalizeKey(prefix);
+    int node = 0;
+    for (size_t i = 0; i < key.size() && node >= 0; i++) node = child(node, key[i]);
+    if (node < 0) return;
+
+    // Most students first (counts are stored negated, so ascending order)
+    vector<pair<int, int> > found;
+    collect(node, field, found);
+    size_t keep = min(found.size(), (size_t)max(limit, 0));
+    partial_sort(found.begin(), found.begin() + keep, found.end());
+    for (size_t f = 0; f < keep; f++) {
+        PlaceSuggestion sug = { nodes[found[f].second].display, -found[f].first, 0 };
+        out.push_back(sug);
+    }
+}
+
+/*
+One step of the trie walk for fuzzy(): 'prevRow' is the Levenshtein row for
+the parent node, and this call fills the row for the path extended by 'c'.
+row[j] = fewest edits to turn the first j letters of 'word' into the path.
+*/
+void PlaceSearchIndex::fuzzyWalk(int node, char c, const string& word, const vector<int>& prevRow,
+                                 Field field, int maxEdits, vector<PlaceSuggestion>& out) const {
+    vector<int> row(word.size() + 1);
+    row[0] = prevRow[0] + 1;
+    int best = row[0];
+    for (size_t j = 1; j <= word.size(); j++) {
+        int insertCost = row[j - 1] + 1;
+        int deleteCost = prevRow[j] + 1;
+        int replaceCost = prevRow[j - 1] + (word[j - 1] == c ? 0 : 1);
+        row[j] = min(insertCost, min(deleteCost, replaceCost));
+        best = min(best, row[j]);
+    }
+
+    if (row[word.size()] <= maxEdits && nodes[node].count[field] > 0) {
+        PlaceSuggestion sug = { nodes[node].display, nodes[node].count[field], row[word.size()] };
+        out.push_back(sug);
+    }
+    if (best > maxEdits) return; // Nothing below here can get back under the limit
+
+    for (size_t k = 0; k < nodes[node].children.size(); k++) {
+        fuzzyWalk(nodes[node].children[k].second, nodes[node].children[k].first,
+                  word, row, field, maxEdits, out);
+    }
+}
+
+void PlaceSearchIndex::fuzzy(const char* text, Field field, int maxEdits, int limit,
+                             vector<PlaceSuggestion>& out) const {
+    out.clear();
+    string word = normalizeKey(text);
+    vector<int> firstRow(word.size() + 1);
+    for (size_t j = 0; j <= word.size(); j++) firstRow[j] = (int)j;
+    for (size_t k = 0; k < nodes[0].children.size(); k++) {
+        fuzzyWalk(nodes[0].children[k].second, nodes[0].children[k].first, word, firstRow, field, maxEdits, out);
+    }
+    keepBest(out, limit);
+}
+
+void PlaceSearchIndex::suggest(const char* text, Field field, int limit, vector<PlaceSuggestion>& out) const {
+    out.clear();
+    string key = normalizeKey(text);
+
+    // 1. Known places that are the query's leading words ("hayatabad" for "hayatabad phase 3")
+    vector<PlaceSuggestion> all;
+    int node = 0;
+    for (size_t i = 0; i < key.size() && node >= 0; i++) {
+        node = child(node, key[i]);
+        if (node >= 0 && i + 1 < key.size() && key[i + 1] == ' ' && nodes[node].count[field] > 0) {
+            PlaceSuggestion sug = { nodes[node].display, nodes[node].count[field], 0 };
+            all.push_back(sug);
+        }
+    }
+
+    // 2. Completions ("sadd" -> "saddar") and 3. typo matches ("sadar" -> "saddar")
+    vector<PlaceSuggestion> more;
+    complete(text, field, limit, more);
+    all.insert(all.end(), more.begin(), more.end());
+    fuzzy(text, field, 2, limit, more);
+    all.insert(all.end(), more.begin(), more.end());
+
+    // Best first, each place once (the same place may come from two sources)
+    sort(all.begin(), all.end(), betterSuggestion);
+    for (size_t a = 0; a < all.size() && (int)out.size() < limit; a++) {
+        bool dup = false;
+        for (size_t o = 0; o < out.size() && !dup; o++) dup = (out[o].text == all[a].text);
+        if (!dup) out.push_back(all[a]);
+    }
+}
+
+/*
+===============================================================================
+FUNCTION: formShardGroups()
+===============================================================================
+Purpose: Form ride groups for ONE destination (one shard)
+Logic (greedy, by pickup proximity):
+  1. Put every student with a known location into a small grid
+  2. Visit students in grid order (row by row, so neighbours are visited
+     together). Each student not yet in a group starts a new group and
+     pulls in the (capacity - 1) closest students still waiting.
+  3. Students whose location is unknown are grouped in file order.
+Parameters:
+  - store: The roster
+  - ids: Positions of the students going to this destination
+  - capacity: Seats per vehicle
+  - groups: Receives the groups
+*/
+static void formShardGroups(const StudentStore& store, const vector<int>& ids, int capacity,
+                            vector<RideGroup>& groups) {
+    // Step 1: Split into students we can place on the map and those we can't
+    vector<int> placed, unplaced;
+    vector<Point> where;
+    for (size_t i = 0; i < ids.size(); i++) {
+        Point p;
+        if (CAMPUS_PLACES.lookup(store.at(ids[i]).currentLocation, p)) {
+            placed.push_back(ids[i]);
+            where.push_back(p);
+        }
+        else {
+            unplaced.push_back(ids[i]);
+        }
+    }
+
+    Point destPoint;
+    bool destKnown = !ids.empty() && CAMPUS_PLACES.lookup(store.at(ids[0]).destination, destPoint);
+
+    // Local grid: cell -> indexes into 'placed' still waiting for a group
+    unordered_map<long long, vector<int> > cells;
+    vector<int> order(placed.size());
+    int minCx = 0, maxCx = 0, minCy = 0, maxCy = 0;
+    for (size_t i = 0; i < placed.size(); i++) {
+        int cx = cellOf(where[i].x), cy = cellOf(where[i].y);
+        if (i == 0) { minCx = maxCx = cx; minCy = maxCy = cy; }
+        minCx = min(minCx, cx); maxCx = max(maxCx, cx);
+        minCy = min(minCy, cy); maxCy = max(maxCy, cy);
+        cells[cellKey(cx, cy)].push_back((int)i);
+        order[i] = (int)i;
+    }
+
+    // Step 2: Visit cells row by row so each seed's neighbours are still free
+    struct ByCell {
+        const vector<Point>* where;
+        bool operator()(int a, int b) const {
+            int ay = cellOf((*where)[a].y), by = cellOf((*where)[b].y);
+            if (ay != by) return ay < by;
+            return cellOf((*where)[a].x) < cellOf((*where)[b].x);
+        }
+    };
+    ByCell byCell = { &where };
+    sort(order.begin(), order.end(), byCell);
+
+    vector<char> assigned(placed.size(), 0);
+    for (size_t o = 0; o < order.size(); o++) {
+        int seed = order[o];
+        if (assigned[seed]) continue;
+
+        // Take the seed out of its cell
+        vector<int>& seedCell = cells[cellKey(cellOf(where[seed].x), cellOf(where[seed].y))];
+        seedCell.erase(find(seedCell.begin(), seedCell.end(), seed));
+        assigned[seed] = 1;
+
+        // Ring search for the closest free riders (same idea as ProximityIndex)
+        int want = capacity - 1;
+        vector<NearbyMatch> found;
+        int cx = cellOf(where[seed].x), cy = cellOf(where[seed].y);
+        int maxRing = max(max(cx - minCx, maxCx - cx), max(cy - minCy, maxCy - cy));
+        for (int r = 0; r <= maxRing && want > 0; r++) {
+            for (int dx = -r; dx <= r; dx++) {
+                for (int dy = -r; dy <= r; dy++) {
+                    if (dx != -r && dx != r && dy != -r && dy != r) continue;
+                    unordered_map<long long, vector<int> >::iterator cell = cells.find(cellKey(cx + dx, cy + dy));
+                    if (cell == cells.end()) continue;
+                    for (size_t e = 0; e < cell->second.size(); e++) {
+                        int c = cell->second[e];
+                        NearbyMatch m = { c, distanceKm(where[seed], where[c]) };
+                        found.push_back(m);
+                    }
+                }
+            }
+            if ((int)found.size() >= want) {
+                nth_element(found.begin(), found.begin() + (want - 1), found.end(), closerMatch);
+                found.resize(want);
+                if (found[want - 1].distanceKm <= r * PROXIMITY_CELL_KM) break;
+            }
+        }
+        if ((int)found.size() > want) {
+            sort(found.begin(), found.end(), closerMatch);
+            found.resize(want);
+        }
+
+        // Build the group; pickup order = always drive to the nearest next rider
+        RideGroup group;
+        group.destination = store.at(placed[seed]).destination;
+        group.members.push_back(placed[seed]);
+        Point at = where[seed];
+        double routeKm = 0;
+        vector<int> pending;
+        for (size_t f = 0; f < found.size(); f++) {
+            int c = found[f].id;
+            assigned[c] = 1;
+            vector<int>& cell = cells[cellKey(cellOf(where[c].x), cellOf(where[c].y))];
+            cell.erase(find(cell.begin(), cell.end(), c));
+            pending.push_back(c);
+        }
+        while (!pending.empty()) {
+            size_t best = 0;
+            for (size_t p = 1; p < pending.size(); p++) {
+                if (distanceKm(at, where[pending[p]]) < distanceKm(at, where[pending[best]])) best = p;
+            }
+            routeKm += distanceKm(at, where[pending[best]]);
+            at = where[pending[best]];
+            group.members.push_back(placed[pending[best]]);
+            pending.erase(pending.begin() + best);
+        }
+
+        /*
+        Detour = (route through every pickup, then to the destination)
+                 minus (driving straight from the first pickup).
+        Without destination coordinates we only know the pickup route.
+        */
+        group.hasRoute = true;
+        group.detourKm = destKnown
+            ? routeKm + distanceKm(at, destPoint) - distanceKm(where[seed], destPoint)
+            : routeKm;
+        groups.push_back(group);
+    }
+
+    // Step 3: Students we cannot place are grouped in file order
+    for (size_t i = 0; i < unplaced.size(); i += capacity) {
+        RideGroup group;
+        group.destination = store.at(unplaced[i]).destination;
+        for (size_t j = i; j < unplaced.size() && j < i + capacity; j++) {
+            group.members.push_back(unplaced[j]);
+        }
+        group.hasRoute = false;
+        group.detourKm = 0;
+        groups.push_back(group);
+    }
+}
+
+/*
+===============================================================================
+FUNCTION: formRideGroups()
+===============================================================================
+Purpose: Form ride groups for every destination at once (e.g. the 4-5pm rush)
+Logic: Each destination is an independent shard. Worker threads repeatedly
+       claim the next unprocessed shard through an atomic counter, so busy
+       and quiet destinations balance out across cores. Each shard writes to
+       its own result list; the lists are joined at the end in shard order,
+       so the output does not depend on thread timing.
+Parameters:
+  - store: The roster (read only while the threads run)
+  - capacity: Seats per vehicle (at least 1)
+  - threads: Worker threads; 0 means one per CPU core
+  - groups: Receives every group formed
+*/
+void formRideGroups(const StudentStore& store, int capacity, int threads, vector<RideGroup>& groups) {
+    groups.clear();
+    if (capacity < 1) capacity = 1;
+
+    vector<const vector<int>*> shards;
+    store.destinationLists(shards);
+
+    if (threads <= 0) threads = (int)thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+    if (threads > (int)shards.size()) threads = (int)shards.size();
+
+    vector<vector<RideGroup> > perShard(shards.size());
+    atomic<int> next(0);
+
+    struct Worker {
+        static void run(const StudentStore* store, const vector<const vector<int>*>* shards, int capacity,
+                        atomic<int>* next, vector<vector<RideGroup> >* perShard) {
+            while (true) {
+                int s = next->fetch_add(1);
+                if (s >= (int)shards->size()) break;
+                formShardGroups(*store, *(*shards)[s], capacity, (*perShard)[s]);
+            }
+        }
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.push_back(thread(Worker::run, &store, &shards, capacity, &next, &perShard));
+    }
+    Worker::run(&store, &shards, capacity, &next, &perShard); // This thread helps too
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+
+    for (size_t s = 0; s < perShard.size(); s++) {
+        groups.insert(groups.end(), perShard[s].begin(), perShard[s].end());
+    }
+}
+
+/*
+===============================================================================
+FUNCTIONS: ChangeLog writing
+===============================================================================
+Each entry is one line, flushed straight away so it reaches the file even if
+the program is closed right after. Appending is cheap no matter how many
+students are registered.
+*/
+bool ChangeLog::openForAppend() {
+    if (!out.is_open()) {
+        out.open(path, ios::app);
+    }
+    if (!out) {
+        cout << "[ERROR] Cannot write to change log " << path << "!\n";
+        return false;
+    }
+    return true;
+}
+
+void ChangeLog::logUpsert(const StudentForm& s) {
+    if (!openForAppend()) return;
+    char times[40];
+    snprintf(times, sizeof(times), "|%u|%u|%u\n", s.registeredAt, s.departFrom, s.departUntil);
+    string line = "U|" + s.name + "|" + s.destination + "|" + s.currentLocation + times;
+    out.write(line.data(), line.size());
+    out.flush();
+    METRICS.addWritten(1, line.size());
+    entryCount++;
+}
+
+void ChangeLog::logDelete(const char* name) {
+    if (!openForAppend()) return;
+    out << "D|" << name << "\n";
+    out.flush();
+    METRICS.addWritten(1, strlen(name) + 3);
+    entryCount++;
+}
+
+void ChangeLog::reset() {
+    if (out.is_open()) out.close();
+    ofstream truncateFile(path, ios::trunc); // Opening with trunc empties the file
+    entryCount = 0;
+}
+
+/*
+===============================================================================
+FUNCTION: ChangeLog::replay()
+===============================================================================
+Purpose: Re-apply logged changes on top of the snapshot loaded from DB_FILE
+Why needed: Changes since the last compaction only exist in the log
+Parameters:
+  - store: The store already filled from DB_FILE
+Returns: int - Number of log entries applied
+Note: A half-written last line (e.g. power cut during a write) has too few
+      fields and is skipped, so the log can always be read back.
+*/
+int ChangeLog::replay(StudentStore& store) {
+    ifstream inFile(path);
+    if (!inFile) return 0;
+
+    int applied = 0;
+    uint64_t bytes = 0;
+    string line;
+    while (getline(inFile, line)) {
+        bytes += line.size() + 1;
+
+        // Split the line on '|' into its fields
+        vector<string> fields;
+        size_t start = 0;
+        while (true) {
+            size_t bar = line.find('|', start);
+            fields.push_back(line.substr(start, bar - start));
+            if (bar == string::npos) break;
+            start = bar + 1;
+        }
+
+        // "U" lines from before departure windows have 4 fields, newer ones 7
+        if (fields[0] == "U" && (fields.size() == 4 || fields.size() == 7)) {
+            StudentForm s;
+            s.name = fields[1];
+            s.destination = fields[2];
+            s.currentLocation = fields[3];
+            if (fields.size() == 7) {
+                s.registeredAt = (uint32_t)strtoul(fields[4].c_str(), NULL, 10);
+                s.departFrom = (uint32_t)strtoul(fields[5].c_str(), NULL, 10);
+                s.departUntil = (uint32_t)strtoul(fields[6].c_str(), NULL, 10);
+            }
+
+            // The store's name index makes each lookup constant time
+            int existing = store.findByName(s.name.c_str());
+            if (existing >= 0) {
+                store.update(existing, s);
+            }
+            else {
+                store.add(s);
+            }
+            applied++;
+        }
+        else if (fields[0] == "D" && fields.size() == 2) {
+            int existing = store.findByName(fields[1].c_str());
+            if (existing >= 0) store.remove(existing); // The last record moves into the hole
+            applied++;
+        }
+        // Anything else is a damaged line: ignore it
+    }
+
+    METRICS.addRead(applied, bytes);
+    entryCount = applied;
+    return applied;
+}
+
+/*
+===============================================================================
+FUNCTIONS: compactDatabase() / compactIfNeeded()
+===============================================================================
+Purpose: Fold the change log back into DB_FILE (or into the shards)
+Order matters: the snapshot is written FIRST and the log emptied SECOND.
+If the program stops in between, replaying the old log again just re-applies
+the same upserts, which gives the same result.
+A sharded database only rewrites the shards whose destinations changed.
+*/
+void compactDatabase(StudentStore& store, ChangeLog& changeLog) {
+    if (isShardedLayout()) {
+        ShardManifest manifest;
+        if (!manifest.read(MANIFEST_FILE) || !saveShards(store, manifest, true)) {
+            cout << "[ERROR] Shards not saved; changes stay in " << LOG_FILE << ".\n";
+            return;
+        }
+    }
+    else {
+        saveAllStudentsToFile(store);
+        // Keep the binary snapshot in step once the user has opted into it
+        struct stat info;
+        if (stat(BIN_FILE, &info) == 0) {
+            saveBinarySnapshot(store, BIN_FILE);
+        }
+    }
+    changeLog.reset();
+    store.markSaved();
+}
+
+void compactIfNeeded(StudentStore& store, ChangeLog& changeLog) {
+    if (changeLog.entries() >= LOG_COMPACT_MIN_ENTRIES &&
+        changeLog.entries() >= store.size() / 4) {
+        compactDatabase(store, changeLog);
+    }
+}
+
+/*
+===============================================================================
+FUNCTION: parseRecordLine()
+===============================================================================
+Purpose: Split one database line at the '|' delimiters:
+             Name | Destination | CurrentLocation | RegisteredAt | DepartFrom | DepartUntil
+                 bar1          bar2               bar3  (the times are optional)
+         A missing field is left empty (or 0 for a time).
+Parameters:
+  - line: The text line (without the newline)
+  - s: Receives the fields (its strings are reused, so call it in a loop freely)
+Returns: void (nothing)
+*/
+void parseRecordLine(const string& line, StudentForm& s) {
+    StatTimer timer(STAT_PARSE, STAT_SAMPLE_PARSE);
+    size_t bar1 = line.find('|');
+    size_t bar2 = (bar1 == string::npos) ? string::npos : line.find('|', bar1 + 1);
+    size_t bar3 = (bar2 == string::npos) ? string::npos : line.find('|', bar2 + 1);
+
+    s.name.assign(line, 0, bar1);
+    if (bar1 != string::npos) s.destination.assign(line, bar1 + 1, bar2 - bar1 - 1);
+    else s.destination.clear();
+    if (bar2 != string::npos) s.currentLocation.assign(line, bar2 + 1, bar3 - bar2 - 1);
+    else s.currentLocation.clear();
+
+    s.registeredAt = s.departFrom = s.departUntil = 0;
+    if (bar3 != string::npos) {
+        // strtoul stops at the next '|' by itself
+        char* next;
+        s.registeredAt = (uint32_t)strtoul(line.c_str() + bar3 + 1, &next, 10);
+        if (*next == '|') s.departFrom = (uint32_t)strtoul(next + 1, &next, 10);
+        if (*next == '|') s.departUntil = (uint32_t)strtoul(next + 1, &next, 10);
+    }
+}
+
+/*
+===============================================================================
+FUNCTIONS: Delimiter scanning
+===============================================================================
+Three versions of the same job, fastest first. Each turns 64 bytes into a
+64-bit mask with bit i set when byte i is '|' or '\n':
+- AVX2: two 32-byte compares per delimiter (x86 CPUs since about 2013)
+- SSE2: four 16-byte compares (every x86-64 CPU)
+- scalar: one byte at a time, for other CPUs and compilers
+The AVX2 version is compiled for AVX2 on its own and only used after asking
+the CPU, so the program still runs on older machines.
+*/
+static void scanDelimitersScalar(const char* text, size_t blocks, uint64_t* masks) {
+    for (size_t b = 0; b < blocks; b++) {
+        const char* p = text + b * 64;
+        uint64_t mask = 0;
+        for (int i = 0; i < 64; i++) {
+            if (p[i] == '|' || p[i] == '\n') mask |= (uint64_t)1 << i;
+        }
+        masks[b] = mask;
+    }
+}
+
+#if RIDE_SHARE_X86
+static void scanDelimitersSse2(const char* text, size_t blocks, uint64_t* masks) {
+    const __m128i bar = _mm_set1_epi8('|');
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (size_t b = 0; b < blocks; b++) {
+        const char* p = text + b * 64;
+        uint64_t mask = 0;
+        for (int part = 0; part < 4; part++) {
+            __m128i bytes = _mm_loadu_si128((const __m128i*)(p + 16 * part));
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, bar), _mm_cmpeq_epi8(bytes, newline));
+            mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(hits) << (16 * part);
+        }
+        masks[b] = mask;
+    }
+}
+
+__attribute__((target("avx2")))
+static void scanDelimitersAvx2(const char* text, size_t blocks, uint64_t* masks) {
+    const __m256i bar = _mm256_set1_epi8('|');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (size_t b = 0; b < blocks; b++) {
+        const char* p = text + b * 64;
+        __m256i low = _mm256_loadu_si256((const __m256i*)p);
+        __m256i high = _mm256_loadu_si256((const __m256i*)(p + 32));
+        uint32_t lowMask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(low, bar), _mm256_cmpeq_epi8(low, newline)));
+        uint32_t highMask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(high, bar), _mm256_cmpeq_epi8(high, newline)));
+        masks[b] = ((uint64_t)highMask << 32) | lowMask;
+    }
+}
+#endif
+
+DelimiterScan bestDelimiterScan(const char** name) {
+#if RIDE_SHARE_X86
+    if (__builtin_cpu_supports("avx2")) {
+        if (name) *name = "avx2";
+        return scanDelimitersAvx2;
+    }
+    if (name) *name = "sse2";
+    return scanDelimitersSse2;
+#else
+    if (name) *name = "scalar";
+    return scanDelimitersScalar;
+#endif
+}
+
+/*
+===============================================================================
+FUNCTION: splitRecords()
+===============================================================================
+Purpose: Split whole database lines in place into StudentViews
+Logic: Delimiter masks are made for 4 KB at a time (pass 1), then each set
+       bit is visited with "count trailing zeros" and cleared (pass 2), so
+       the ordinary bytes of a name or place are never looked at one by one.
+       Fields are the same as in parseRecordLine(): missing ones are empty
+       (or 0 for a time) and anything after the sixth field is ignored.
+Parameters:
+  - text, size: Whole lines ('\n' after the last one); changed in place
+  - scan: Which delimiter scan to use (see bestDelimiterScan())
+  - rows: Receives one StudentView per accepted line, pointing into text
+Returns: long - Number of lines rejected because a field was too long
+*/
+static inline int lowestBit(uint64_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask);
+#else
+    int b = 0;
+    while (!(mask & 1)) { mask >>= 1; b++; }
+    return b;
+#endif
+}
+
+// Digits up to the end of the field (the times never need strtoul's extras)
+static uint32_t parseTime(const char* p) {
+    uint32_t value = 0;
+    while (*p >= '0' && *p <= '9') value = value * 10 + (uint32_t)(*p++ - '0');
+    return value;
+}
+
+// One line from 'start' to its '\n' at 'end'; bars[] holds its first min(barCount, 5) '|'
+static bool splitLine(char* start, char* end, char* const* bars, int barCount, StudentView& v) {
+    if (end > start && end[-1] == '\r') end--; // Files saved on Windows
+    *end = '\0';
+
+    int fields = min(barCount, 5) + 1;
+    char* begins[6];
+    begins[0] = start;
+    for (int f = 1; f < fields; f++) {
+        begins[f] = bars[f - 1] + 1;
+        *bars[f - 1] = '\0';
+    }
+    for (int f = 0; f < fields && f < 3; f++) {
+        char* fieldEnd = (f + 1 < fields) ? bars[f] : end;
+        if (fieldEnd - begins[f] > (ptrdiff_t)MAX_FIELD_BYTES) return false;
+    }
+
+    v.name = begins[0];
+    v.destination = fields > 1 ? begins[1] : "";
+    v.currentLocation = fields > 2 ? begins[2] : "";
+    v.registeredAt = fields > 3 ? parseTime(begins[3]) : 0;
+    v.departFrom = fields > 4 ? parseTime(begins[4]) : 0;
+    v.departUntil = fields > 5 ? parseTime(begins[5]) : 0;
+    return true;
+}
+
+long splitRecords(char* text, size_t size, DelimiterScan scan, vector<StudentView>& rows) {
+    const size_t GROUP_BLOCKS = 64; // 64 masks = 4 KB of text per scan call
+    uint64_t masks[GROUP_BLOCKS];
+    char* lineStart = text;
+    char* bars[5];
+    int barCount = 0;
+    long rejected = 0;
+
+    for (size_t base = 0; base < size; base += GROUP_BLOCKS * 64) {
+        size_t length = min(size - base, GROUP_BLOCKS * 64);
+        size_t blocks = length / 64;
+
+        // Pass 1: masks for this group (a last partial block is padded with zeros)
+        scan(text + base, blocks, masks);
+        if (length % 64 != 0) {
+            char tail[64];
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, text + base + blocks * 64, length % 64);
+            scan(tail, 1, masks + blocks);
+            blocks++;
+        }
+
+        // Pass 2: visit the delimiters only
+        for (size_t b = 0; b < blocks; b++) {
+            uint64_t mask = masks[b];
+            while (mask != 0) {
+                char* at = text + base + b * 64 + lowestBit(mask);
+                mask &= mask - 1; // Clear the bit we just used
+                if (*at == '|') {
+                    if (barCount < 5) bars[barCount] = at;
+                    barCount++;
+                    continue;
+                }
+                if (at != lineStart && !(at == lineStart + 1 && *lineStart == '\r')) {
+                    StudentView v;
+                    if (splitLine(lineStart, at, bars, barCount, v)) rows.push_back(v);
+                    else rejected++;
+                }
+                lineStart = at + 1;
+                barCount = 0;
+            }
+        }
+    }
+    return rejected;
+}
+
+/*
+===============================================================================
+FUNCTIONS: RecordLoader
+===============================================================================
+*/
+RecordLoader::RecordLoader(const vector<string>& paths, int threads)
+    : paths(paths), nextPath(0), released(0), maxAhead(2 * (size_t)max(1, threads)),
+      inputDone(false), bytes(0), scan(bestDelimiterScan(NULL)) {}
+
+/*
+Fill 'text' with about RECORD_CHUNK_BYTES of whole lines. Whatever follows
+the last '\n' is kept in 'carry' for the next chunk; the end of a file
+always ends a line, and small files share a chunk.
+*/
+bool RecordLoader::readChunk(vector<char>& text) {
+    text.swap(carry);
+    carry.clear();
+    while (true) {
+        if (!in.is_open()) {
+            if (nextPath == paths.size()) return false; // Nothing left to read
+            in.clear();
+            in.open(paths[nextPath++].c_str(), ios::binary);
+            if (!in) {
+                in.close(); // A missing file is just empty
+                continue;
+            }
+        }
+
+        size_t old = text.size();
+        text.resize(old + RECORD_CHUNK_BYTES);
+        in.read(&text[old], RECORD_CHUNK_BYTES);
+        size_t got = (size_t)in.gcount();
+        text.resize(old + got);
+        bytes += got;
+
+        if (got < RECORD_CHUNK_BYTES) {
+            // End of this file
+            in.close();
+            if (!text.empty() && text.back() != '\n') text.push_back('\n');
+            if (text.size() >= RECORD_CHUNK_BYTES) return true;
+            continue; // Room for the next file too
+        }
+
+        // Cut after the last whole line (a line longer than the chunk just keeps growing it)
+        size_t cut = text.size();
+        while (cut > 0 && text[cut - 1] != '\n') cut--;
+        if (cut > 0) {
+            carry.assign(text.begin() + cut, text.end());
+            text.resize(cut);
+            return true;
+        }
+    }
+}
+
+bool RecordLoader::splitNext() {
+    RecordChunk* chunk;
+    {
+        lock_guard<mutex> guard(lock);
+        if (inputDone || chunks.size() >= released + maxAhead) return false;
+        chunks.emplace_back();
+        chunk = &chunks.back(); // deque: stays put when more chunks are added
+        inputDone = !readChunk(chunk->text);
+    }
+
+    // Split outside the lock, so other threads can read (and split) meanwhile
+    bool timing = METRICS.enabled;
+    chrono::steady_clock::time_point t0;
+    if (timing) t0 = chrono::steady_clock::now();
+    if (!chunk->text.empty()) {
+        chunk->rejected = splitRecords(&chunk->text[0], chunk->text.size(), scan, chunk->rows);
+    }
+    uint64_t lines = chunk->rows.size() + chunk->rejected;
+    if (timing && lines > 0) {
+        // Lines are counted one by one; one time per chunk (its average line) is recorded
+        uint64_t ns = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now() - t0).count();
+        METRICS.count(STAT_PARSE, (unsigned)lines);
+        METRICS.latency(STAT_PARSE).record(ns / lines);
+    }
+    chunk->ready = true;
+    return true;
+}
+
+RecordChunk* RecordLoader::waitFor(size_t k) {
+    while (true) {
+        {
+            lock_guard<mutex> guard(lock);
+            if (k < chunks.size()) {
+                if (chunks[k].ready) return &chunks[k];
+            }
+            else if (inputDone) {
+                return NULL;
+            }
+        }
+        if (!splitNext()) this_thread::yield(); // Someone else is splitting chunk k
+    }
+}
+
+void RecordLoader::release(size_t k) {
+    lock_guard<mutex> guard(lock);
+    vector<char>().swap(chunks[k].text);
+    vector<StudentView>().swap(chunks[k].rows);
+    released = k + 1;
+}
+
+bool RecordLoader::finished() {
+    lock_guard<mutex> guard(lock);
+    return inputDone;
+}
+
+void RecordLoader::run(RecordLoader* loader) {
+    while (!loader->finished()) {
+        if (!loader->splitNext()) this_thread::yield(); // Too far ahead: wait for the adding thread
+    }
+}
+
+/*
+===============================================================================
+FUNCTION: loadRecordFiles()
+===============================================================================
+Purpose: Load database files into the store using a RecordLoader
+Logic: Worker threads read and split chunks; this thread adds them to the
+       store in file order (the store itself is not thread-safe), splitting
+       chunks too whenever the next one is not ready yet.
+Parameters:
+  - store: The StudentStore that receives the records
+  - paths: Files to read, in order
+  - threads: Threads to use (0 = one per CPU core)
+  - expected: Students to make room for up front (0 = unknown)
+Returns: int - Number of students loaded
+*/
+int loadRecordFiles(StudentStore& store, const vector<string>& paths, int threads, long expected) {
+    if (threads <= 0) threads = (int)thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+
+    RecordLoader loader(paths, threads);
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) {
+        pool.push_back(thread(RecordLoader::run, &loader));
+    }
+    if (expected > 0) store.reserve((int)expected);
+
+    int count = 0;
+    long rejected = 0;
+    for (size_t k = 0; RecordChunk* chunk = loader.waitFor(k); k++) {
+        for (size_t r = 0; r < chunk->rows.size(); r++) {
+            store.add(chunk->rows[r]);
+        }
+        count += (int)chunk->rows.size();
+        rejected += chunk->rejected;
+        loader.release(k);
+    }
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+
+    if (rejected > 0) {
+        cout << "[WARNING] Skipped " << rejected << " lines with a field longer than "
+             << MAX_FIELD_BYTES << " bytes.\n";
+    }
+    METRICS.addRead(count, loader.bytesRead());
+    return count;
+}
+
+/*
+===============================================================================
+FUNCTION: loadStudentsFromFile()
+===============================================================================
+Purpose: Read all student records from the database file into the store
+Parameters: 
+  - store: The StudentStore that receives the records (it grows as needed)
+Returns: int - Number of students actually loaded
+Logic: A RecordLoader reads the file in large chunks and splits them on
+       every CPU core; the students are added in file order.
+File Format: Each line is:
+    Name|Destination|CurrentLocation|RegisteredAt|DepartFrom|DepartUntil
+Example: John Smith|Saddar|Library|1760700000|1760700000|1760703600
+The three times (Unix seconds) are optional: lines written before
+departure windows existed get "registered now" and the default window.
+*/
+int loadStudentsFromFile(StudentStore& store) {
+    // A missing file simply loads nobody
+    return loadRecordFiles(store, vector<string>(1, DB_FILE), 0, 0);
+}
+
+/*
+===============================================================================
+FUNCTION: saveAllStudentsToFile()
+===============================================================================
+Purpose: Write all students from the store to the database file
+Note: This OVERWRITES the entire file with current data, so it is only used
+      for compaction - single registrations go to the ChangeLog instead
+Parameters:
+  - store: The StudentStore containing all students
+Returns: void (nothing)
+*/
+void saveAllStudentsToFile(const StudentStore& store) {
+    StatTimer timer(STAT_SAVE);
+
+    // Open file for writing (output mode)
+    // This automatically OVERWRITES the existing file
+    ofstream outFile(DB_FILE);
+    
+    // Check if file opened successfully
+    if (!outFile) {
+        cout << "[ERROR] Cannot write to database file!\n";
+        cout << "[INFO] Make sure the program has write permissions.\n";
+        return; // Exit function early
+    }
+
+    /*
+    Write each student to file in format: Name|Destination|CurrentLocation
+    Example output: John Smith|Saddar|Library
+    */
+    for (int i = 0; i < store.size(); i++) {
+        StudentView s = store.at(i);
+        outFile << s.name << "|"              // Write name + delimiter
+                << s.destination << "|"        // Write destination + delimiter
+                << s.currentLocation << "|"    // Write location + delimiter
+                << s.registeredAt << "|"       // Write the times
+                << s.departFrom << "|"
+                << s.departUntil << "\n";     // ... + newline (no per-line flush)
+    }
+
+    METRICS.addWritten(store.size(), (uint64_t)outFile.tellp());
+    outFile.close(); // Close the file
+}
+
+/*
+===============================================================================
+FUNCTION: saveBinarySnapshot()
+===============================================================================
+Purpose: Write the store in the binary snapshot format (see BinarySnapshot)
+Parameters:
+  - store: The StudentStore to write
+  - path: File to create (overwritten if it exists)
+Returns: bool - true on success
+*/
+bool saveBinarySnapshot(const StudentStore& store, const char* path) {
+    StatTimer timer(STAT_SAVE);
+    string strings;                           // The string table being built
+    unordered_map<string, uint32_t> offsets;  // Text -> its offset in 'strings'
+    vector<BinaryRecord> records(store.size());
+    map<string, vector<uint32_t> > dests;     // Sorted: lower-cased destination -> ids
+
+    // Add a string to the table once, reusing it if we have seen it before
+    struct Intern {
+        static uint32_t add(string& table, unordered_map<string, uint32_t>& seen, const string& text) {
+            unordered_map<string, uint32_t>::iterator it = seen.find(text);
+            if (it != seen.end()) return it->second;
+            uint32_t off = (uint32_t)table.size();
+            table.append(text);
+            table.push_back('\0');
+            seen[text] = off;
+            return off;
+        }
+    };
+
+    for (int i = 0; i < store.size(); i++) {
+        StudentView s = store.at(i);
+        records[i].nameOff = Intern::add(strings, offsets, s.name);
+        records[i].destOff = Intern::add(strings, offsets, s.destination);
+        records[i].locationOff = Intern::add(strings, offsets, s.currentLocation);
+        records[i].registeredAt = s.registeredAt;
+        records[i].departFrom = s.departFrom;
+        records[i].departUntil = s.departUntil;
+        dests[normalizeKey(s.destination)].push_back((uint32_t)i);
+    }
+
+    // Destination directory and the id lists it points into
+    vector<BinaryDestEntry> dir;
+    vector<uint32_t> ids;
+    ids.reserve(store.size());
+    for (map<string, vector<uint32_t> >::iterator it = dests.begin(); it != dests.end(); ++it) {
+        BinaryDestEntry e;
+        e.keyOff = Intern::add(strings, offsets, it->first);
+        e.firstId = (uint32_t)ids.size();
+        e.idCount = (uint32_t)it->second.size();
+        ids.insert(ids.end(), it->second.begin(), it->second.end());
+        dir.push_back(e);
+    }
+
+    BinaryHeader header;
+    memcpy(header.magic, "RSDB", 4);
+    header.version = BINARY_FORMAT_VERSION;
+    header.recordCount = (uint32_t)records.size();
+    header.destCount = (uint32_t)dir.size();
+    header.recordsOffset = sizeof(BinaryHeader);
+    header.destOffset = header.recordsOffset + records.size() * sizeof(BinaryRecord);
+    header.idsOffset = header.destOffset + dir.size() * sizeof(BinaryDestEntry);
+    header.stringsOffset = header.idsOffset + ids.size() * sizeof(uint32_t);
+    header.stringsSize = strings.size();
+
+    ofstream outFile(path, ios::binary | ios::trunc);
+    if (!outFile) {
+        cout << "[ERROR] Cannot write binary snapshot " << path << "!\n";
+        return false;
+    }
+    outFile.write((const char*)&header, sizeof(header));
+    if (!records.empty()) outFile.write((const char*)&records[0], records.size() * sizeof(BinaryRecord));
+    if (!dir.empty()) outFile.write((const char*)&dir[0], dir.size() * sizeof(BinaryDestEntry));
+    if (!ids.empty()) outFile.write((const char*)&ids[0], ids.size() * sizeof(uint32_t));
+    outFile.write(strings.data(), strings.size());
+    METRICS.addWritten(store.size(), (uint64_t)outFile.tellp());
+    return (bool)outFile;
+}
+
+/*
+===============================================================================
+FUNCTION: BinarySnapshot::open()
+===============================================================================
+Purpose: Map a binary snapshot into memory and check that it is usable
+Parameters:
+  - path: The binary snapshot file
+Returns: bool - true if the file exists and every offset in it is in range
+Note: Checking offsets is one quick pass over fixed-width numbers. It is
+      not parsing, but it means a damaged file is rejected instead of
+      making us read outside the mapping later.
+*/
+bool BinarySnapshot::open(const char* path) {
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(BinaryHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size = (size_t)info.st_size;
+    void* p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+    if (p == MAP_FAILED) return false;
+    data = (char*)p;
+    mapped = true;
+#else
+    // No mmap on Windows builds: read the whole file into memory instead
+    ifstream inFile(path, ios::binary);
+    if (!inFile) return false;
+    copy.assign(istreambuf_iterator<char>(inFile), istreambuf_iterator<char>());
+    if (copy.size() < sizeof(BinaryHeader)) return false;
+    data = &copy[0];
+    size = copy.size();
+#endif
+
+    header = (const BinaryHeader*)data;
+    bool ok = memcmp(header->magic, "RSDB", 4) == 0 &&
+              header->version == BINARY_FORMAT_VERSION &&
+              header->recordsOffset + (uint64_t)header->recordCount * sizeof(BinaryRecord) <= header->destOffset &&
+              header->destOffset + (uint64_t)header->destCount * sizeof(BinaryDestEntry) <= header->idsOffset &&
+              header->idsOffset <= header->stringsOffset &&
+              header->stringsOffset + header->stringsSize == size &&
+              (header->stringsSize == 0 || data[size - 1] == '\0');
+    if (!ok) {
+        close();
+        return false;
+    }
+
+    records = (const BinaryRecord*)(data + header->recordsOffset);
+    dests = (const BinaryDestEntry*)(data + header->destOffset);
+    idList = (const uint32_t*)(data + header->idsOffset);
+    strings = data + header->stringsOffset;
+
+    uint64_t idSlots = (header->stringsOffset - header->idsOffset) / sizeof(uint32_t);
+    for (uint32_t i = 0; i < header->recordCount && ok; i++) {
+        ok = records[i].nameOff < header->stringsSize &&
+             records[i].destOff < header->stringsSize &&
+             records[i].locationOff < header->stringsSize;
+    }
+    for (uint32_t d = 0; d < header->destCount && ok; d++) {
+        ok = dests[d].keyOff < header->stringsSize &&
+             (uint64_t)dests[d].firstId + dests[d].idCount <= idSlots;
+    }
+    for (uint64_t k = 0; k < idSlots && ok; k++) {
+        ok = idList[k] < header->recordCount;
+    }
+    if (!ok) {
+        cout << "[ERROR] Binary snapshot " << path << " is damaged.\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void BinarySnapshot::close() {
+#ifndef _WIN32
+    if (mapped && data != NULL) munmap(data, size);
+#endif
+    vector<char>().swap(copy);
+    data = NULL;
+    size = 0;
+    mapped = false;
+    header = NULL;
+}
+
+StudentView BinarySnapshot::view(int i) const {
+    StudentView v;
+    v.name = name(i);
+    v.destination = destination(i);
+    v.currentLocation = currentLocation(i);
+    v.registeredAt = records[i].registeredAt;
+    v.departFrom = records[i].departFrom;
+    v.departUntil = records[i].departUntil;
+    return v;
+}
+
+int BinarySnapshot::findByDestination(const char* destination, const uint32_t** ids) const {
+    string key = normalizeKey(destination);
+
+    // Binary search: the directory is sorted by key
+    int lo = 0, hi = (int)header->destCount - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        int cmp = strcmp(strings + dests[mid].keyOff, key.c_str());
+        if (cmp == 0) {
+            *ids = idList + dests[mid].firstId;
+            return (int)dests[mid].idCount;
+        }
+        if (cmp < 0) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    *ids = NULL;
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: loadStudentsFromBinary()
+===============================================================================
+Purpose: Copy every record from a mapped binary snapshot into the store
+Parameters:
+  - store: The StudentStore that receives the records (emptied first)
+  - snapshot: An opened BinarySnapshot
+Returns: int - Number of students loaded
+*/
+int loadStudentsFromBinary(StudentStore& store, const BinarySnapshot& snapshot) {
+    store.clear();
+    store.students.resize(snapshot.count()); // One allocation instead of many
+
+    /*
+    The string table holds each place once, so the same place always has
+    the same offset: intern it the first time and reuse the id after that.
+    */
+    unordered_map<const char*, uint32_t> placeIds;
+    for (int i = 0; i < snapshot.count(); i++) {
+        Student& s = store.students[i];
+        s.name = store.names.add(snapshot.name(i));
+        StudentView v = snapshot.view(i);
+        s.registeredAt = v.registeredAt;
+        s.departFrom = v.departFrom;
+        s.departUntil = v.departUntil;
+        const char* texts[2] = { snapshot.destination(i), snapshot.currentLocation(i) };
+        uint32_t* fields[2] = { &s.destination, &s.currentLocation };
+        for (int f = 0; f < 2; f++) {
+            unordered_map<const char*, uint32_t>::iterator it = placeIds.find(texts[f]);
+            if (it == placeIds.end()) {
+                it = placeIds.insert(make_pair(texts[f], store.placeNames.intern(texts[f]))).first;
+            }
+            *fields[f] = it->second;
+        }
+    }
+
+    /*
+    The file already groups record ids by lower-cased destination, in file
+    order, which is exactly what the store's index holds. Copy it across
+    instead of looking up every record's destination again.
+    */
+    store.destIndex.resize(store.placeNames.keyCount());
+    for (int d = 0; d < snapshot.destinationCount(); d++) {
+        const uint32_t* ids;
+        int n = snapshot.destIds(d, &ids);
+        int key = store.placeNames.findKey(snapshot.destKey(d));
+        if (key >= 0) store.destIndex[key].assign(ids, ids + n);
+    }
+
+    // The name index, expiry buckets, proximity grid and place trie are not in the file
+    store.byName.reserve(snapshot.count());
+    for (int i = 0; i < snapshot.count(); i++) {
+        store.byName.insert(i, store.students);
+        store.indexExpiry(i);
+        store.indexProximity(i);
+        store.indexPlaces(i, +1);
+    }
+    METRICS.addRead(snapshot.count(), snapshot.bytes());
+    return snapshot.count();
+}
+
+/*
+===============================================================================
+FUNCTION: loadSnapshot()
+===============================================================================
+Purpose: Load the newest snapshot into the store
+Logic: A sharded database is read from its shards. Otherwise use BIN_FILE
+       if it exists and is at least as new as DB_FILE (someone may have
+       edited the text file by hand since), or else read the text file.
+       Either way the store then counts as saved, so the next compaction
+       of a sharded database only rewrites what changes after this.
+Parameters:
+  - store: The StudentStore that receives the records
+Returns: int - Number of students loaded
+*/
+bool isBinarySnapshotCurrent() {
+    struct stat textInfo, binInfo;
+    bool haveText = stat(DB_FILE, &textInfo) == 0;
+    bool haveBin = stat(BIN_FILE, &binInfo) == 0;
+    return haveBin && (!haveText || binInfo.st_mtime >= textInfo.st_mtime);
+}
+
+int loadSnapshot(StudentStore& store) {
+    StatTimer timer(STAT_LOAD);
+    int loaded = -1; // Not loaded yet
+    if (isShardedLayout()) {
+        ShardManifest manifest;
+        if (manifest.read(MANIFEST_FILE)) {
+            loaded = loadShards(store, manifest, 0);
+        }
+        else {
+            // Nothing is saved over the shards until the manifest is fixed (see compactDatabase())
+            cout << "[ERROR] " << MANIFEST_FILE << " is damaged. Fix it, or remove it to use "
+                 << DB_FILE << " again.\n";
+            loaded = 0;
+        }
+    }
+    else if (isBinarySnapshotCurrent()) {
+        BinarySnapshot snapshot;
+        if (snapshot.open(BIN_FILE)) loaded = loadStudentsFromBinary(store, snapshot);
+        else cout << "[INFO] Falling back to " << DB_FILE << ".\n";
+    }
+    if (loaded < 0) loaded = loadStudentsFromFile(store);
+    store.markSaved();
+    return loaded;
+}
+
+/*
+===============================================================================
+FUNCTION: convertToBinary()
+===============================================================================
+Purpose: "convert" command - turn the text database into BIN_FILE
+Logic: Load DB_FILE plus any pending change log entries, then write the
+       binary snapshot. The text file is left untouched.
+Parameters: None
+Returns: int - 0 on success, 1 on failure (used as the program's exit code)
+*/
+int convertToBinary() {
+    if (isShardedLayout()) {
+        cout << "[ERROR] The database is sharded; run \"unshard\" first.\n";
+        return 1;
+    }
+    StudentStore store;
+    ChangeLog changeLog(LOG_FILE);
+    loadStudentsFromFile(store);
+    changeLog.replay(store);
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    if (!saveBinarySnapshot(store, BIN_FILE)) return 1;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    cout << "Wrote " << store.size() << " students to " << BIN_FILE
+         << " in " << ms << " ms.\n";
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTIONS: ShardManifest / shardOf() / isShardedLayout()
+===============================================================================
+The manifest is a small text file so it can be read (and fixed) by hand.
+A manifest that cannot be read is reported, never silently replaced:
+writing a fresh one would lose track of the shards that hold the data.
+*/
+bool ShardManifest::read(const char* path) {
+    ifstream in(path);
+    string line;
+    if (!in || !getline(in, line) || line != "ride_share shards 1") return false;
+
+    files.clear();
+    counts.clear();
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        istringstream fields(line);
+        string word, file;
+        int index;
+        long count;
+        if (!(fields >> word >> index >> file >> count) || word != "shard" || index != shardCount()) {
+            return false;
+        }
+        files.push_back(file);
+        counts.push_back(count);
+    }
+    return shardCount() > 0;
+}
+
+bool ShardManifest::write(const char* path) const {
+    ofstream out(path, ios::trunc);
+    out << "ride_share shards 1\n";
+    for (int i = 0; i < shardCount(); i++) {
+        out << "shard " << i << " " << files[i] << " " << counts[i] << "\n";
+    }
+    return (bool)out;
+}
+
+void ShardManifest::create(int shardCount) {
+    files.clear();
+    counts.assign(shardCount, 0);
+    for (int i = 0; i < shardCount; i++) {
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "%02d.txt", i);
+        files.push_back(string(SHARD_FILE_PREFIX) + suffix);
+    }
+}
+
+// FNV-1a, like the name index, so the same destination always lands in the same shard
+int shardOf(const string& destinationKey, int shardCount) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < destinationKey.size(); i++) {
+        hash = (hash ^ (unsigned char)destinationKey[i]) * 16777619u;
+    }
+    return (int)(hash % (uint32_t)shardCount);
+}
+
+bool isShardedLayout() {
+    struct stat info;
+    return stat(MANIFEST_FILE, &info) == 0;
+}
+
+// One database line (same format as saveAllStudentsToFile()) added to 'out'
+static void appendRecordLine(string& out, const StudentView& s) {
+    char times[40];
+    snprintf(times, sizeof(times), "|%u|%u|%u\n", s.registeredAt, s.departFrom, s.departUntil);
+    out += s.name;
+    out += '|';
+    out += s.destination;
+    out += '|';
+    out += s.currentLocation;
+    out += times;
+}
+
+/*
+===============================================================================
+FUNCTION: saveShards()
+===============================================================================
+Purpose: Write the store as shards and update the manifest
+Logic: Group the destination keys by shard. A shard is rewritten only if
+       one of its destinations changed since the store was last saved
+       (StudentStore::destinationChanged()), so a registration costs one
+       shard's worth of writing instead of the whole roster.
+Parameters:
+  - store: The StudentStore to write
+  - manifest: Shard file names; the student counts are updated
+  - onlyChanged: false = rewrite every shard (e.g. a new layout)
+Returns: bool - true if every file was written
+*/
+bool saveShards(const StudentStore& store, ShardManifest& manifest, bool onlyChanged) {
+    StatTimer timer(STAT_SAVE);
+    int shards = manifest.shardCount();
+
+    // Step 1: Which destinations live in which shard, and which shards changed
+    vector<vector<uint32_t> > keysOf(shards);
+    vector<char> dirty(shards, (onlyChanged && !store.allChanged()) ? 0 : 1);
+    for (int key = 0; key < store.destinationKeyCount(); key++) {
+        if (store.studentsGoingTo(key).empty() && !store.destinationChanged(key)) continue;
+        int shard = shardOf(store.destinationKeyText(key), shards);
+        keysOf[shard].push_back(key);
+        if (store.destinationChanged(key)) dirty[shard] = 1;
+    }
+
+    // Step 2: Rewrite the changed shards, one large write each
+    bool ok = true;
+    string text;
+    for (int shard = 0; shard < shards; shard++) {
+        if (!dirty[shard]) continue;
+        text.clear();
+        long count = 0;
+        for (size_t k = 0; k < keysOf[shard].size(); k++) {
+            const vector<int>& ids = store.studentsGoingTo(keysOf[shard][k]);
+            for (size_t m = 0; m < ids.size(); m++) {
+                appendRecordLine(text, store.at(ids[m]));
+            }
+            count += (long)ids.size();
+        }
+
+        ofstream out(manifest.files[shard].c_str(), ios::trunc);
+        out.write(text.data(), text.size());
+        if (!out) {
+            cout << "[ERROR] Cannot write shard " << manifest.files[shard] << "!\n";
+            ok = false;
+            continue;
+        }
+        manifest.counts[shard] = count;
+        METRICS.addWritten(count, text.size());
+    }
+
+    // Step 3: The manifest last, so it never names a shard that was not written
+    return manifest.write(MANIFEST_FILE) && ok;
+}
+
+/*
+===============================================================================
+FUNCTION: loadShards()
+===============================================================================
+Purpose: Fill the store from every shard
+Logic: The shards are read one after the other by a RecordLoader, which
+       splits them on several threads; small shards share a chunk.
+Parameters:
+  - store: The StudentStore that receives the records
+  - manifest: Which files to read (and how many students to expect)
+  - threads: Threads to use (0 = one per CPU core)
+Returns: int - Number of students loaded
+*/
+int loadShards(StudentStore& store, const ShardManifest& manifest, int threads) {
+    long expected = 0;
+    for (int i = 0; i < manifest.shardCount(); i++) expected += manifest.counts[i];
+    return loadRecordFiles(store, manifest.files, threads, expected);
+}
+
+/*
+===============================================================================
+FUNCTIONS: shardDatabase() / unshardDatabase()
+===============================================================================
+Purpose: "shard [N]" and "unshard" commands - switch between one DB_FILE
+         and N shard files
+Logic: Load everything (snapshot + change log), write the new layout, and
+       only then remove the old files and empty the log.
+Returns: int - 0 on success, 1 on failure (used as the program's exit code)
+*/
+int shardDatabase(int shardCount) {
+    if (shardCount < 1 || shardCount > MAX_SHARD_COUNT) {
+        cout << "[ERROR] The number of shards must be between 1 and " << MAX_SHARD_COUNT << ".\n";
+        return 1;
+    }
+    StudentStore store;
+    ChangeLog changeLog(LOG_FILE);
+    loadSnapshot(store);
+    changeLog.replay(store);
+
+    // Shards of an older layout that the new one does not use are removed
+    ShardManifest old;
+    bool hadShards = isShardedLayout() && old.read(MANIFEST_FILE);
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    ShardManifest manifest;
+    manifest.create(shardCount);
+    if (!saveShards(store, manifest, false)) return 1;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    changeLog.reset();
+    remove(DB_FILE);
+    remove(BIN_FILE);
+    for (int i = shardCount; hadShards && i < old.shardCount(); i++) remove(old.files[i].c_str());
+
+    cout << "Wrote " << store.size() << " students to " << shardCount << " shards ("
+         << MANIFEST_FILE << ") in " << ms << " ms.\n";
+    return 0;
+}
+
+int unshardDatabase() {
+    ShardManifest manifest;
+    if (!isShardedLayout() || !manifest.read(MANIFEST_FILE)) {
+        cout << "The database is not sharded.\n";
+        return 1;
+    }
+    StudentStore store;
+    ChangeLog changeLog(LOG_FILE);
+    loadShards(store, manifest, 0);
+    changeLog.replay(store);
+
+    // DB_FILE first; the shards are only removed once it is written
+    saveAllStudentsToFile(store);
+    changeLog.reset();
+    remove(MANIFEST_FILE);
+    for (int i = 0; i < manifest.shardCount(); i++) remove(manifest.files[i].c_str());
+
+    cout << "Wrote " << store.size() << " students to " << DB_FILE << ".\n";
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: registerStudent()
+===============================================================================
+Purpose: Register a new student OR update existing student's information
+Logic: If student name already exists, UPDATE their info; otherwise ADD new
+Parameters:
+  - store: The in-memory roster (already loaded at startup)
+  - changeLog: Where the change is recorded permanently
+Returns: void (nothing)
+*/
+void registerStudent(StudentStore& store, ChangeLog& changeLog) {
+    cout << "\n--- REGISTER / UPDATE STATUS ---\n";
+
+    // Step 1: Create a new StudentForm for input
+    StudentForm newStudent;
+    
+    // Step 2: Get student information from user (any length)
+    cout << "Enter your Name: ";
+    getline(cin, newStudent.name);
+
+    cout << "Enter your Destination (e.g., Saddar, Hayatabad): ";
+    getline(cin, newStudent.destination);
+
+    cout << "Enter your Current Location (e.g., Library, Cafe): ";
+    getline(cin, newStudent.currentLocation);
+
+    /*
+    Step 3: When can they leave? The request expires once the window is over,
+    and only students whose windows overlap are matched
+    */
+    string answer;
+    cout << "Leaving in how many minutes? (Enter = now): ";
+    getline(cin, answer);
+    int leaveIn = atoi(answer.c_str());
+    cout << "How long can you wait, in minutes? (Enter = " << DEFAULT_DEPARTURE_WINDOW_MIN << "): ";
+    getline(cin, answer);
+    int window = answer.empty() ? DEFAULT_DEPARTURE_WINDOW_MIN : atoi(answer.c_str());
+    setDepartureWindow(newStudent, leaveIn, window);
+
+    /*
+    Step 4: UPDATE the student if the name already exists (case-insensitive),
+    otherwise ADD them, and append the change to the log (permanent storage)
+    */
+    if (upsertStudent(store, changeLog, newStudent)) {
+        cout << "\n✓ SUCCESS: Your details have been UPDATED!\n";
+    }
+    else {
+        cout << "\n✓ SUCCESS: You have been registered!\n";
+    }
+    cout << "[Info] Data saved to disk permanently.\n";
+}
+
+/*
+===============================================================================
+FUNCTION: upsertStudent()
+===============================================================================
+Purpose: The shared "register or update" logic used by the menu and the
+         command line
+Logic: If the name already exists (ignoring case) update that student,
+       otherwise add a new one. Either way the change is appended to the
+       change log, which may trigger a compaction.
+Parameters:
+  - store: The in-memory roster
+  - changeLog: Where the change is recorded permanently
+  - s: The student's details
+Returns: bool - true if an existing student was UPDATED, false if ADDED
+*/
+bool upsertStudent(StudentStore& store, ChangeLog& changeLog, const StudentForm& s) {
+    StatTimer timer(STAT_UPSERT, STAT_SAMPLE_UPSERT);
+
+    // findByName() uses the name index (ignoring case): constant time, however many students
+    int existing = store.findByName(s.name.c_str());
+    if (existing >= 0) {
+        /*
+        UPDATE existing student's information (also moves them in the index).
+        The store compares place ids, so re-registering with the same
+        destination and location is just two integer compares.
+        */
+        store.update(existing, s);
+    }
+    else {
+        // Student not found, add as NEW student (the store grows as needed)
+        store.add(s);
+    }
+
+    /*
+    Log the times the store actually used (defaults filled in), so replaying
+    the log later gives the same departure window instead of a new one
+    */
+    StudentForm logged = s;
+    StudentView stored = store.at(existing >= 0 ? existing : store.size() - 1);
+    logged.registeredAt = stored.registeredAt;
+    logged.departFrom = stored.departFrom;
+    logged.departUntil = stored.departUntil;
+    changeLog.logUpsert(logged);
+    compactIfNeeded(store, changeLog);
+    return existing >= 0;
+}
+
+/*
+===============================================================================
+FUNCTION: findRidePartners()
+===============================================================================
+Purpose: Search for students going to a specific destination who can
+         leave around the same time (their departure windows overlap)
+Shows: Student names and their current locations
+Parameters:
+  - store: The in-memory roster (already loaded at startup)
+Returns: void (nothing)
+*/
+void findRidePartners(const StudentStore& store) {
+    string targetDest; // To store destination user is searching for
+    cout << "\n--- FIND RIDE PARTNERS ---\n";
+    
+    // Step 1: Check if there's any data
+    if (store.empty()) {
+        cout << "No data found. Be the first to register!\n";
+        return; // Exit function
+    }
+    
+    // Step 2: Ask user where they want to go
+    cout << "Where do you want to go? ";
+    getline(cin, targetDest);
+
+    // Step 3: And when: the user's own departure window
+    string answer;
+    cout << "Leaving in how many minutes? (Enter = now): ";
+    getline(cin, answer);
+    StudentForm when;
+    setDepartureWindow(when, atoi(answer.c_str()), DEFAULT_DEPARTURE_WINDOW_MIN);
+
+    bool found = false; // Flag to track if we find any matches
+
+    // Step 4: Display table header
+    cout << "\nSearching for students going to: " << targetDest << "...\n";
+    cout << "-----------------------------------------------------------\n";
+    cout << "Name\t\tCurrent Location\n";
+    cout << "----\t\t----------------\n";
+
+    /*
+    Step 5: Look up matching students in the destination index
+    The index is case-insensitive, so "Saddar" matches "saddar", "SADDAR", "SaDdAr":
+    the typed text is turned into a key id ONCE, and all those spellings share it
+    Only the matching students are visited, no matter how big the roster is
+    */
+    const vector<int>* matches = store.findByDestination(targetDest.c_str());
+    if (matches != NULL) {
+        for (size_t m = 0; m < matches->size(); m++) {
+            StudentView s = store.at((*matches)[m]);
+            if (!windowsOverlap(s.departFrom, s.departUntil, when.departFrom, when.departUntil)) continue;
+            // Found a match! Display the student info
+            cout << s.name << "\t\t" 
+                 << s.currentLocation << "\n";
+            found = true;
+        }
+    }
+
+    // Step 6: Display appropriate message based on results
+    if (!found) {
+        cout << "No students found going to '" << targetDest << "' yet.\n";
+
+        // Maybe a typo, a shortened name, or a longer one: offer close matches
+        vector<PlaceSuggestion> ideas;
+        store.placeSearch().suggest(targetDest.c_str(), PlaceSearchIndex::DESTINATION, 5, ideas);
+        if (!ideas.empty()) {
+            cout << "Did you mean: ";
+            for (size_t d = 0; d < ideas.size(); d++) {
+                cout << (d ? ", " : "") << ideas[d].text << " (" << ideas[d].students << ")";
+            }
+            cout << "?\n";
+        }
+    } else {
+        cout << "-----------------------------------------------------------\n";
+    }
+
+    /*
+    Step 7 (optional): Rank partners by distance
+    If we know where the user is, show the closest students going to the
+    same destination or to one nearby (within NEARBY_DESTINATION_KM)
+    */
+    string myLocation;
+    cout << "\nYour current location, to see the closest partners (Enter to skip): ";
+    getline(cin, myLocation);
+    if (myLocation.empty()) return;
+
+    vector<NearbyMatch> nearest;
+    if (!store.findNearest(targetDest.c_str(), myLocation.c_str(), NEAREST_PARTNERS, NEARBY_DESTINATION_KM, nearest)) {
+        cout << "Sorry, '" << myLocation << "' is not a place we know the position of.\n";
+        return;
+    }
+    // Same departure time only
+    size_t kept = 0;
+    for (size_t m = 0; m < nearest.size(); m++) {
+        StudentView s = store.at(nearest[m].id);
+        if (windowsOverlap(s.departFrom, s.departUntil, when.departFrom, when.departUntil)) {
+            nearest[kept++] = nearest[m];
+        }
+    }
+    nearest.resize(kept);
+    if (nearest.empty()) {
+        cout << "Nobody with a known location is going there or nearby at that time.\n";
+        return;
+    }
+    cout << "\nClosest partners going to or near " << targetDest << ":\n";
+    cout << "Name\t\tDestination\tCurrent Location\tDistance (km)\n";
+    for (size_t m = 0; m < nearest.size(); m++) {
+        StudentView s = store.at(nearest[m].id);
+        cout << s.name << "\t\t" << s.destination << "\t\t" << s.currentLocation
+             << "\t\t" << nearest[m].distanceKm << "\n";
+    }
+}
+
+/*
+===============================================================================
+FUNCTION: viewAllStudents()
+===============================================================================
+Purpose: Display registered students in a formatted table, one page
+         (LIST_PAGE_SIZE rows) at a time, optionally only those going to
+         one destination
+Shows: Serial number, Name, Destination, Current Location
+Parameters:
+  - store: The in-memory roster (already loaded at startup)
+Returns: void (nothing)
+*/
+void viewAllStudents(const StudentStore& store) {
+    cout << "\n--- ALL REGISTERED STUDENTS ---\n";
+    
+    // Step 1: Check if database is empty
+    int studentCount = store.size();
+    if (studentCount == 0) {
+        cout << "No students registered yet. Database is empty.\n";
+        return; // Exit function
+    }
+
+    // Step 2: Optional destination filter (uses the destination index)
+    string filter;
+    cout << "Only show students going to (Enter for everyone): ";
+    getline(cin, filter);
+    const vector<int>* matches = NULL;
+    int total = studentCount;
+    if (!filter.empty()) {
+        matches = store.findByDestination(filter.c_str());
+        total = (matches == NULL) ? 0 : (int)matches->size();
+        if (total == 0) {
+            cout << "No students found going to '" << filter << "'.\n";
+            return;
+        }
+    }
+
+    /*
+    Step 3: Show one page at a time
+    Rows go through a RowWriter, so each page is written to the screen in
+    one go instead of field by field
+    */
+    for (int first = 0; first < total; first += LIST_PAGE_SIZE) {
+        int last = min(total, first + LIST_PAGE_SIZE);
+        {
+            RowWriter writer(cout, RowWriter::TABLE);
+            cout << "-----------------------------------------------------------\n";
+            writer.header();
+            for (int r = first; r < last; r++) {
+                writer.row(r + 1, store.at(matches ? (*matches)[r] : r)); // Serial number starts from 1
+            }
+        } // The writer flushes the page here
+
+        // Step 4: Footer, and ask before showing the next page
+        cout << "-----------------------------------------------------------\n";
+        cout << "Showing " << (first + 1) << "-" << last << " of " << total << " students\n";
+        if (last == total) break;
+        cout << "Press Enter for the next page, or q to stop: ";
+        string answer;
+        getline(cin, answer);
+        if (answer == "q" || answer == "Q") break;
+    }
+}
+
+/*
+===============================================================================
+FUNCTION: clearAllData()
+===============================================================================
+Purpose: Delete ALL student records from the database
+Warning: This is PERMANENT and cannot be undone!
+Parameters:
+  - store: The in-memory roster (emptied together with the file)
+  - changeLog: The change log (emptied too, so nothing is replayed later)
+Returns: void (nothing)
+*/
+void clearAllData(StudentStore& store, ChangeLog& changeLog) {
+    // Step 1: Check the in-memory store for data
+    int studentCount = store.size();
+    
+    // Step 2: If database is already empty
+    if (studentCount == 0) {
+        cout << "No data to clear.\n";
+        return; // Exit function
+    }
+
+    // Step 3: Ask for confirmation (safety feature)
+    char confirm;
+    cout << "\n⚠️  WARNING: This will delete ALL " << studentCount << " student records!\n";
+    cout << "Are you sure? (y/n): ";
+    cin >> confirm;
+    cin.ignore(); // Clear newline from buffer
+
+    // Step 4: Only proceed if user confirms with 'y' or 'Y'
+    if (confirm == 'y' || confirm == 'Y') {
+        /*
+        Forget the in-memory copy, then save the empty store over every
+        file that holds students: DB_FILE (or every shard) and the binary
+        snapshot, if there is one. Pending log entries are dropped too, so
+        nothing comes back on the next start.
+        */
+        store.clear();
+        compactDatabase(store, changeLog);
+        cout << "✓ All data has been permanently deleted.\n";
+    } 
+    else {
+        cout << "Operation cancelled.\n"; // User said no
+    }
+}
+
+/*
+===============================================================================
+COMMAND-LINE MODE
+===============================================================================
+Lets scripts drive the program without answering menu prompts, e.g.
+
+    ./ride_share register "Ali Khan" Saddar Library
+    ./ride_share find Saddar
+    ./ride_share import new_students.csv
+
+Each command loads the roster (or, for "find", just maps the binary
+snapshot when it is current), does its job, and exits with status 0 on
+success or 1 on error. Output rows use the same Name|Destination|Location
+layout as DB_FILE so they are easy to feed into other tools.
+*/
+
+// Print the list of commands
+void printUsage() {
+    cout << "Usage: ride_share [command] [arguments]\n"
+         << "Without a command the interactive menu starts.\n\n"
+         << "Commands:\n"
+         << "  register NAME DESTINATION LOCATION [LEAVE_IN_MIN [WINDOW_MIN]]\n"
+         << "                                      Register or update one student (default: now, "
+         << DEFAULT_DEPARTURE_WINDOW_MIN << " min)\n"
+         << "  find DESTINATION [LEAVE_IN_MIN]     List students going to DESTINATION around then\n"
+         << "  near DESTINATION LOCATION [K]       K closest students going to (or near) DESTINATION\n"
+         << "  groups [CAPACITY] [THREADS]         Form ride groups for everyone (default 4 seats)\n"
+         << "  suggest PREFIX [loc]                Autocomplete destinations (or locations)\n"
+         << "  search TEXT [loc]                   Typo-tolerant destination (or location) search\n"
+         << "  list [LIST OPTIONS]                 List students, streamed straight from the files\n"
+         << "      LIST OPTIONS: --dest D --offset N --limit N --page P --page-size N\n"
+         << "                    --format pipe|table|csv|jsonl\n"
+         << "  remove NAME                         Delete one student\n"
+         << "  import FILE                         Bulk register from a CSV or pipe-delimited file\n"
+         << "  clear --yes                         Delete ALL students\n"
+         << "  convert                             Write the binary snapshot (" << BIN_FILE << ")\n"
+         << "  shard [N]                           Split the database into N shard files (default "
+         << DEFAULT_SHARD_COUNT << ")\n"
+         << "  unshard                             Go back to one database file\n"
+         << "  generate [OPTIONS] [--out FILE]     Write a synthetic roster in the database format\n"
+         << "  bench [OPTIONS] [--changes N] [--format tsv]  Time load/save/register/update/find/scan/list\n"
+         << "      OPTIONS: --students N --destinations D --skew S --name-len L --seed X\n"
+         << "  bench-index                         Benchmark the destination index\n"
+         << "  bench-list                          Benchmark streamed vs loaded listing\n"
+         << "  bench-expiry                        Memory and expiry cost under a stream of registrations\n"
+         << "  bench-load                          Benchmark text vs binary cold start\n"
+         << "  bench-near                          Benchmark nearest-partner queries\n"
+         << "  bench-groups                        Benchmark batch ride group formation\n"
+         << "  bench-search                        Benchmark autocomplete / fuzzy search at 1M students\n"
+         << "  bench-shards                        Benchmark sharded vs single-file load, find and save\n"
+         << "  bench-parse                         Benchmark database line splitting (SIMD, threads)\n"
+         << "  serve [SOCKET]                      Run as a server for many clients at once\n"
+         << "  loadgen [THREADS] [REQUESTS] [WRITE%] [SOCKET]  Load-test a running server\n"
+         << "  stats [COMMAND ...]                 Run COMMAND (default: just load), then show timings\n"
+         << "  bench-stats                         Measure the cost of collecting the stats\n"
+         << "  help                                Show this message\n";
+}
+
+// Load the full roster (snapshot + change log) for commands that need it
+void loadDatabase(StudentStore& store, ChangeLog& changeLog) {
+    ensureFileExists();
+    loadPlaces();
+    loadSnapshot(store);
+    changeLog.replay(store);
+    store.expire(nowSeconds());
+}
+
+// Print one student as Name|Destination|CurrentLocation
+void printStudentRow(const char* name, const char* destination, const char* location) {
+    cout << name << "|" << destination << "|" << location << "\n";
+}
+
+/*
+===============================================================================
+FUNCTION: commandFind()
+===============================================================================
+Purpose: "find DESTINATION [LEAVE_IN_MIN]" - print every student going to
+         DESTINATION whose departure window overlaps ours (leaving in
+         LEAVE_IN_MIN minutes, default now, for DEFAULT_DEPARTURE_WINDOW_MIN)
+Fast path: when the change log is empty, the answer comes straight from
+           the mapped binary snapshot (if current), or from the one shard
+           holding DESTINATION (if sharded), without loading the roster.
+Returns: int - 0 (exit code)
+*/
+int commandFind(const char* destination, int leaveInMin) {
+    StudentForm when;
+    setDepartureWindow(when, leaveInMin, DEFAULT_DEPARTURE_WINDOW_MIN);
+
+    struct stat logInfo;
+    bool logEmpty = stat(LOG_FILE, &logInfo) != 0 || logInfo.st_size == 0;
+
+    if (logEmpty && isBinarySnapshotCurrent()) {
+        BinarySnapshot snapshot;
+        if (snapshot.open(BIN_FILE)) {
+            const uint32_t* ids;
+            int n = snapshot.findByDestination(destination, &ids);
+            for (int m = 0; m < n; m++) {
+                StudentView s = snapshot.view(ids[m]);
+                if (windowsOverlap(s.departFrom, s.departUntil, when.departFrom, when.departUntil)) {
+                    printStudentRow(s.name, s.destination, s.currentLocation);
+                }
+            }
+            return 0;
+        }
+    }
+    if (logEmpty && isShardedLayout()) {
+        ShardManifest manifest;
+        if (manifest.read(MANIFEST_FILE)) {
+            // Everyone going to this destination is in the same shard
+            vector<string> shard(1, manifest.files[shardOf(normalizeKey(destination), manifest.shardCount())]);
+            RecordLoader loader(shard, 1);
+            for (size_t k = 0; RecordChunk* chunk = loader.waitFor(k); k++) {
+                for (size_t r = 0; r < chunk->rows.size(); r++) {
+                    const StudentView& s = chunk->rows[r];
+                    if (strcasecmp(s.destination, destination) == 0 &&
+                        windowsOverlap(s.departFrom, s.departUntil, when.departFrom, when.departUntil)) {
+                        printStudentRow(s.name, s.destination, s.currentLocation);
+                    }
+                }
+                loader.release(k);
+            }
+            return 0;
+        }
+    }
+
+    StudentStore store;
+    ChangeLog changeLog(LOG_FILE);
+    loadDatabase(store, changeLog);
+    const vector<int>* matches = store.findByDestination(destination);
+    if (matches != NULL) {
+        for (size_t m = 0; m < matches->size(); m++) {
+            StudentView s = store.at((*matches)[m]);
+            if (windowsOverlap(s.departFrom, s.departUntil, when.departFrom, when.departUntil)) {
+                printStudentRow(s.name, s.destination, s.currentLocation);
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: splitImportLine()
+===============================================================================
+Purpose: Split one line of an import file into fields
+Parameters:
+  - line: The text line (without the newline)
+  - delimiter: '|' for pipe files, ',' for CSV
+  - fields: Receives the fields
+Note: CSV fields may be wrapped in double quotes so they can contain commas;
+      a doubled quote ("") inside quotes stands for one quote character.
+*/
+void splitImportLine(const string& line, char delimiter, vector<string>& fields) {
+    fields.clear();
+    string current;
+    bool inQuotes = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (delimiter == ',' && c == '"') {
+            if (inQuotes && i + 1 < line.size() && line[i + 1] == '"') {
+                current += '"'; // Escaped quote
+                i++;
+            }
+            else {
+                inQuotes = !inQuotes;
+            }
+        }
+        else if (c == delimiter && !inQuotes) {
+            fields.push_back(current);
+            current.clear();
+        }
+        else if (c != '\r') { // Ignore Windows line endings
+            current += c;
+        }
+    }
+    fields.push_back(current);
+}
+
+/*
+===============================================================================
+FUNCTION: commandImport()
+===============================================================================
+Purpose: "import FILE" - register many students in a single pass
+Logic:
+  1. Load the roster once and build a name -> position map
+  2. Read the file line by line; each row is Name,Destination,Location
+     (CSV) or Name|Destination|Location (pipe). The format is chosen from
+     the first line. A header row starting with "name" is skipped.
+  3. Rows are matched by name ignoring case, exactly like registerStudent:
+     an existing student is updated, a new one is added. If a name appears
+     twice in the file, the later row wins.
+  4. Commit ONCE: write a new snapshot and empty the change log, instead of
+     logging every row separately.
+Returns: int - 0 on success, 1 if the file cannot be read
+*/
+int commandImport(const char* path) {
+    ifstream inFile(path);
+    if (!inFile) {
+        cout << "[ERROR] Cannot open import file " << path << "\n";
+        return 1;
+    }
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    StudentStore store;
+    ChangeLog changeLog(LOG_FILE);
+    loadDatabase(store, changeLog);
+
+    int added = 0, updated = 0, skipped = 0, rows = 0;
+    char delimiter = 0;
+    string line;
+    vector<string> fields;
+    while (getline(inFile, line)) {
+        if (line.empty() || line == "\r") continue;
+        if (delimiter == 0) {
+            // First real line decides the format
+            delimiter = (line.find('|') != string::npos) ? '|' : ',';
+            splitImportLine(line, delimiter, fields);
+            if (normalizeKey(fields[0].c_str()) == "name") continue; // Header row
+        }
+        else {
+            splitImportLine(line, delimiter, fields);
+        }
+        rows++;
+
+        if (fields.size() < 3 || fields[0].empty() || fields[1].empty()) {
+            skipped++; // Not enough information to register this row
+            continue;
+        }
+
+        StudentForm s;
+        s.name = fields[0];
+        s.destination = fields[1];
+        s.currentLocation = fields[2];
+
+        int existing = store.findByName(s.name.c_str());
+        if (existing >= 0) {
+            store.update(existing, s);
+            updated++;
+        }
+        else {
+            store.add(s);
+            added++;
+        }
+    }
+
+    // One commit for the whole file
+    compactDatabase(store, changeLog);
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << "Imported " << rows << " rows: " << added << " added, " << updated
+         << " updated, " << skipped << " skipped.\n";
+    cout << "Time: " << seconds << " s (" << (long)(rows / (seconds > 0 ? seconds : 1e-9))
+         << " records/second). Total students: " << store.size() << "\n";
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: runCommandLine()
+===============================================================================
+Purpose: Run one command given on the command line (see printUsage())
+Parameters:
+  - argc, argv: The program arguments from main()
+Returns: int - Exit code: 0 on success, 1 on error or bad usage
+*/
+int runCommandLine(int argc, char* argv[]) {
+    string command = argv[1];
+
+    if (command == "help" || command == "--help" || command == "-h") {
+        printUsage();
+        return 0;
+    }
+    if (command == "stats") {
+        // On its own: load the roster and show what that cost. Otherwise run the command first
+        int status = 0;
+        if (argc == 2) {
+            StudentStore store;
+            ChangeLog changeLog(LOG_FILE);
+            loadDatabase(store, changeLog);
+        }
+        else {
+            status = runCommandLine(argc - 1, argv + 1);
+        }
+        cout << "--- stats ---\n";
+        METRICS.report(cout);
+        return status;
+    }
+    if (command == "bench-stats" && argc == 2) {
+        return runStatsBenchmark();
+    }
+    if (command == "register" && argc >= 5 && argc <= 7) {
+        StudentStore store;
+        ChangeLog changeLog(LOG_FILE);
+        loadDatabase(store, changeLog);
+
+        StudentForm s;
+        s.name = argv[2];
+        s.destination = argv[3];
+        s.currentLocation = argv[4];
+        setDepartureWindow(s, (argc >= 6) ? atoi(argv[5]) : 0,
+                           (argc == 7) ? atoi(argv[6]) : DEFAULT_DEPARTURE_WINDOW_MIN);
+        cout << (upsertStudent(store, changeLog, s) ? "UPDATED " : "REGISTERED ") << s.name << "\n";
+        return 0;
+    }
+    if (command == "find" && (argc == 3 || argc == 4)) {
+        return commandFind(argv[2], (argc == 4) ? atoi(argv[3]) : 0);
+    }
+    if (command == "near" && (argc == 4 || argc == 5)) {
+        StudentStore store;
+        ChangeLog changeLog(LOG_FILE);
+        loadDatabase(store, changeLog);
+
+        int k = (argc == 5) ? atoi(argv[4]) : NEAREST_PARTNERS;
+        vector<NearbyMatch> matches;
+        if (!store.findNearest(argv[2], argv[3], k, NEARBY_DESTINATION_KM, matches)) {
+            cout << "[ERROR] Unknown location '" << argv[3] << "'. Add it to " << PLACES_FILE << ".\n";
+            return 1;
+        }
+        // Name|Destination|Location|DistanceKm, closest first
+        for (size_t m = 0; m < matches.size(); m++) {
+            StudentView s = store.at(matches[m].id);
+            cout << s.name << "|" << s.destination << "|" << s.currentLocation << "|"
+                 << matches[m].distanceKm << "\n";
+        }
+        return 0;
+    }
+    if (command == "groups" && argc >= 2 && argc <= 4) {
+        StudentStore store;
+        ChangeLog changeLog(LOG_FILE);
+        loadDatabase(store, changeLog);
+
+        int capacity = (argc >= 3) ? atoi(argv[2]) : DEFAULT_VEHICLE_CAPACITY;
+        int threads = (argc >= 4) ? atoi(argv[3]) : 0;
+        vector<RideGroup> groups;
+        formRideGroups(store, capacity, threads, groups);
+
+        // One line per group: Destination|member, member, ...|detour (km or "?")
+        for (size_t g = 0; g < groups.size(); g++) {
+            cout << groups[g].destination << "|";
+            for (size_t m = 0; m < groups[g].members.size(); m++) {
+                cout << (m ? ", " : "") << store.at(groups[g].members[m]).name;
+            }
+            cout << "|";
+            if (groups[g].hasRoute) cout << groups[g].detourKm << "\n";
+            else cout << "?\n";
+        }
+        return 0;
+    }
+    if ((command == "suggest" || command == "search") && (argc == 3 || argc == 4)) {
+        StudentStore store;
+        ChangeLog changeLog(LOG_FILE);
+        loadDatabase(store, changeLog);
+
+        PlaceSearchIndex::Field field = (argc == 4 && strcmp(argv[3], "loc") == 0)
+            ? PlaceSearchIndex::LOCATION : PlaceSearchIndex::DESTINATION;
+        vector<PlaceSuggestion> results;
+        if (command == "suggest") store.placeSearch().complete(argv[2], field, 10, results);
+        else store.placeSearch().suggest(argv[2], field, 10, results);
+
+        // Place|Students|Typos
+        for (size_t r = 0; r < results.size(); r++) {
+            cout << results[r].text << "|" << results[r].students << "|" << results[r].edits << "\n";
+        }
+        return 0;
+    }
+    if (command == "list") {
+        return commandList(argc, argv);
+    }
+    if (command == "remove" && argc == 3) {
+        StudentStore store;
+        ChangeLog changeLog(LOG_FILE);
+        loadDatabase(store, changeLog);
+        int i = store.findByName(argv[2]);
+        if (i < 0) {
+            cout << "[ERROR] No student named '" << argv[2] << "'.\n";
+            return 1;
+        }
+        store.remove(i);
+        changeLog.logDelete(argv[2]);
+        compactIfNeeded(store, changeLog);
+        cout << "REMOVED " << argv[2] << "\n";
+        return 0;
+    }
+    if (command == "import" && argc == 3) {
+        return commandImport(argv[2]);
+    }
+    if (command == "clear" && argc == 3 && strcmp(argv[2], "--yes") == 0) {
+        // Same effect as menu option 4, without the prompt
+        ensureFileExists();
+        StudentStore empty;
+        ChangeLog changeLog(LOG_FILE);
+        compactDatabase(empty, changeLog); // Empty snapshot(s), empty log
+        cout << "All data has been permanently deleted.\n";
+        return 0;
+    }
+    if (command == "convert" && argc == 2) {
+        return convertToBinary();
+    }
+    if (command == "shard" && argc <= 3) {
+        return shardDatabase(argc == 3 ? atoi(argv[2]) : DEFAULT_SHARD_COUNT);
+    }
+    if (command == "unshard" && argc == 2) {
+        return unshardDatabase();
+    }
+    if (command == "bench-shards" && argc == 2) {
+        return runShardBenchmark();
+    }
+    if (command == "bench-parse" && argc == 2) {
+        return runParseBenchmark();
+    }
+    if (command == "generate") {
+        return runGenerateCommand(argc, argv);
+    }
+    if (command == "bench") {
+        return runBenchmarkSuite(argc, argv);
+    }
+    if (command == "bench-index" && argc == 2) {
+        return runIndexBenchmark();
+    }
+    if (command == "bench-list" && argc == 2) {
+        return runListBenchmark();
+    }
+    if (command == "bench-expiry" && argc == 2) {
+        return runExpiryBenchmark();
+    }
+    if (command == "bench-load" && argc == 2) {
+        return runLoadBenchmark();
+    }
+    if (command == "bench-near" && argc == 2) {
+        return runProximityBenchmark();
+    }
+    if (command == "bench-groups" && argc == 2) {
+        return runGroupBenchmark();
+    }
+    if (command == "bench-search" && argc == 2) {
+        return runSearchBenchmark();
+    }
+    if (command == "serve" && argc <= 3) {
+        return runServer(argc == 3 ? argv[2] : SERVER_SOCKET);
+    }
+    if (command == "loadgen" && argc <= 6) {
+        return runLoadGenerator(argc >= 6 ? argv[5] : SERVER_SOCKET,
+                                argc >= 3 ? atoi(argv[2]) : 8,
+                                argc >= 4 ? atoi(argv[3]) : 10000,
+                                argc >= 5 ? atoi(argv[4]) : 5);
+    }
+
+    cout << "[ERROR] Unknown command or wrong number of arguments.\n\n";
+    printUsage();
+    return 1;
+}
+
+/*
+===============================================================================
+SERVER MODE
+===============================================================================
+"./ride_share serve" runs a daemon on a local Unix-domain socket so many
+users can search and register at the same time, without two copies of the
+program overwriting each other's changes in DB_FILE.
+
+Protocol: one request per line, answered with text lines:
+    FIND <destination>            -> Name|Destination|Location lines, then "END"
+                                     (students who can leave within the next
+                                     DEFAULT_DEPARTURE_WINDOW_MIN minutes)
+    REGISTER <name>|<dest>|<loc>[|<leave in min>|<window min>]
+                                  -> "OK REGISTERED" or "OK UPDATED"
+    COUNT                         -> number of students
+    STATS                         -> the Metrics report (since the server started), then "END"
+    PING                          -> "PONG"
+    QUIT                          -> closes the connection
+Anything else gets "ERROR <reason>".
+
+Concurrency design (readers never wait for writers):
+- One WRITER thread owns the StudentStore and ChangeLog. Connection threads
+  put REGISTER requests on a queue and wait for the writer's answer, so
+  changes are applied one at a time, in order, and are never lost.
+- READERS use an immutable ServerView (a snapshot grouped by destination).
+  After each batch of writes the writer publishes a NEW view with
+  atomic_store(); readers grab the current one with atomic_load() and keep
+  using it even if a newer one appears meanwhile. Unchanged destination
+  lists are shared between old and new views, so a write only copies the
+  lists of the destinations it touched.
+- Expired requests are removed by the writer too: it wakes up at least once
+  per EXPIRY_BUCKET_SECONDS, and republishes if anything expired.
+*/
+#ifndef _WIN32
+
+struct ServerView {
+    unordered_map<string, shared_ptr<const vector<StudentForm> > > byDestination; // lower-cased key -> students
+    int studentCount;
+};
+
+// A REGISTER request waiting for the writer thread
+struct WriteRequest {
+    StudentForm student;
+    promise<bool> updated; // Set to true if an existing student was updated
+};
+
+class RideShareServer {
+public:
+    RideShareServer() : changeLog(LOG_FILE), stopping(false) {}
+
+    void start();                                   // Load data, publish a view, start the writer
+    void serveConnection(int fd);                   // Handle one client until it disconnects
+    shared_ptr<const ServerView> currentView() const { return atomic_load(&view); }
+    bool submitRegister(const StudentForm& s);         // Queue a write and wait; returns "updated?"
+
+private:
+    StudentStore store;       // Owned by the writer thread after start()
+    ChangeLog changeLog;
+    shared_ptr<const ServerView> view;
+
+    mutex queueLock;
+    condition_variable queueReady;
+    vector<WriteRequest*> queue;
+    bool stopping;
+    thread writer;
+
+    void writerLoop();
+    void publish(const vector<string>& changedKeys); // Build and swap in a new view
+    void expireAndCollect(vector<string>& changedKeys); // Drop expired requests; adds keys if any went
+};
+
+// Send the whole string, coping with partial writes. false if the client went away
+static bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += (size_t)n;
+    }
+    return true;
+}
+
+/*
+Reads a socket one line at a time. recv() returns whatever bytes have
+arrived, which may be half a line or several lines, so they are buffered.
+*/
+class LineReader {
+public:
+    explicit LineReader(int fd) : fd(fd), start(0) {}
+
+    bool readLine(string& line) {
+        while (true) {
+            size_t nl = buffer.find('\n', start);
+            if (nl != string::npos) {
+                line.assign(buffer, start, nl - start);
+                if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+                start = nl + 1;
+                return true;
+            }
+            buffer.erase(0, start);
+            start = 0;
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buffer.append(chunk, (size_t)n);
+        }
+    }
+
+private:
+    int fd;
+    string buffer;
+    size_t start; // Where the next unread line begins in 'buffer'
+};
+
+void RideShareServer::start() {
+    ensureFileExists();
+    loadPlaces();
+    loadSnapshot(store);
+    changeLog.replay(store);
+    store.expire(nowSeconds());
+
+    // First view: every destination
+    vector<string> keys;
+    vector<const vector<int>*> lists;
+    store.destinationLists(lists);
+    for (size_t l = 0; l < lists.size(); l++) {
+        keys.push_back(normalizeKey(store.at((*lists[l])[0]).destination));
+    }
+    publish(keys);
+
+    writer = thread(&RideShareServer::writerLoop, this);
+}
+
+void RideShareServer::publish(const vector<string>& changedKeys) {
+    shared_ptr<const ServerView> old = atomic_load(&view);
+    shared_ptr<ServerView> next(new ServerView());
+    if (old) next->byDestination = old->byDestination; // Shares every list
+
+    for (size_t k = 0; k < changedKeys.size(); k++) {
+        const vector<int>* ids = store.findByDestination(changedKeys[k].c_str());
+        if (ids == NULL) {
+            next->byDestination.erase(changedKeys[k]);
+            continue;
+        }
+        // Copy the text out: the view must not point into the store, which keeps changing
+        shared_ptr<vector<StudentForm> > rows(new vector<StudentForm>(ids->size()));
+        for (size_t i = 0; i < ids->size(); i++) {
+            StudentView s = store.at((*ids)[i]);
+            (*rows)[i].name = s.name;
+            (*rows)[i].destination = s.destination;
+            (*rows)[i].currentLocation = s.currentLocation;
+            (*rows)[i].registeredAt = s.registeredAt;
+            (*rows)[i].departFrom = s.departFrom;
+            (*rows)[i].departUntil = s.departUntil;
+        }
+        next->byDestination[changedKeys[k]] = rows;
+    }
+    next->studentCount = store.size();
+    atomic_store(&view, shared_ptr<const ServerView>(next));
+}
+
+void RideShareServer::writerLoop() {
+    while (true) {
+        // Take everything that is waiting, in one go
+        vector<WriteRequest*> batch;
+        {
+            unique_lock<mutex> lock(queueLock);
+            // Wake up now and then even without requests, to expire old ones
+            if (queue.empty() && !stopping) queueReady.wait_for(lock, chrono::seconds(EXPIRY_BUCKET_SECONDS));
+            if (queue.empty() && stopping) return;
+            batch.swap(queue);
+        }
+
+        // Apply the batch; remember which destinations changed
+        vector<string> changedKeys;
+        expireAndCollect(changedKeys);
+        if (batch.empty()) {
+            if (!changedKeys.empty()) publish(changedKeys);
+            continue;
+        }
+        vector<bool> results;
+        for (size_t b = 0; b < batch.size(); b++) {
+            const StudentForm& s = batch[b]->student;
+            int existing = store.findByName(s.name.c_str());
+            if (existing >= 0) changedKeys.push_back(normalizeKey(store.at(existing).destination));
+            changedKeys.push_back(normalizeKey(s.destination.c_str()));
+            results.push_back(upsertStudent(store, changeLog, s));
+        }
+        sort(changedKeys.begin(), changedKeys.end());
+        changedKeys.erase(unique(changedKeys.begin(), changedKeys.end()), changedKeys.end());
+
+        // Publish BEFORE answering, so a client that registers and then
+        // searches always sees its own change
+        publish(changedKeys);
+        for (size_t b = 0; b < batch.size(); b++) batch[b]->updated.set_value(results[b]);
+    }
+}
+
+void RideShareServer::expireAndCollect(vector<string>& changedKeys) {
+    if (store.expire(nowSeconds()) == 0) return;
+    // Removals can touch any destination: refresh them all (publish() drops empty ones)
+    shared_ptr<const ServerView> old = atomic_load(&view);
+    unordered_map<string, shared_ptr<const vector<StudentForm> > >::const_iterator it;
+    for (it = old->byDestination.begin(); it != old->byDestination.end(); ++it) {
+        changedKeys.push_back(it->first);
+    }
+}
+
+bool RideShareServer::submitRegister(const StudentForm& s) {
+    WriteRequest request;
+    request.student = s;
+    future<bool> answer = request.updated.get_future();
+    {
+        lock_guard<mutex> lock(queueLock);
+        queue.push_back(&request);
+    }
+    queueReady.notify_one();
+    return answer.get(); // Wait for the writer
+}
+
+void RideShareServer::serveConnection(int fd) {
+    LineReader reader(fd);
+    string line;
+    while (reader.readLine(line)) {
+        string reply;
+        size_t space = line.find(' ');
+        string verb = line.substr(0, space);
+        string arg = (space == string::npos) ? "" : line.substr(space + 1);
+
+        if (verb == "FIND") {
+            StatTimer timer(STAT_LOOKUP, STAT_SAMPLE_LOOKUP);
+            shared_ptr<const ServerView> v = currentView(); // Never blocks on writers
+            unordered_map<string, shared_ptr<const vector<StudentForm> > >::const_iterator it =
+                v->byDestination.find(normalizeKey(arg.c_str()));
+            if (it != v->byDestination.end()) {
+                const vector<StudentForm>& rows = *it->second;
+                StudentForm when;
+                setDepartureWindow(when, 0, DEFAULT_DEPARTURE_WINDOW_MIN);
+                for (size_t r = 0; r < rows.size(); r++) {
+                    if (!windowsOverlap(rows[r].departFrom, rows[r].departUntil, when.departFrom, when.departUntil)) continue;
+                    reply += rows[r].name; reply += '|';
+                    reply += rows[r].destination; reply += '|';
+                    reply += rows[r].currentLocation; reply += '\n';
+                }
+            }
+            reply += "END\n";
+        }
+        else if (verb == "REGISTER") {
+            vector<string> fields;
+            splitImportLine(arg, '|', fields);
+            if ((fields.size() != 3 && fields.size() != 5) || fields[0].empty() || fields[1].empty()) {
+                reply = "ERROR expected REGISTER name|destination|location[|leave in min|window min]\n";
+            }
+            else {
+                StudentForm s;
+                s.name = fields[0];
+                s.destination = fields[1];
+                s.currentLocation = fields[2];
+                if (fields.size() == 5) setDepartureWindow(s, atoi(fields[3].c_str()), atoi(fields[4].c_str()));
+                reply = submitRegister(s) ? "OK UPDATED\n" : "OK REGISTERED\n";
+            }
+        }
+        else if (verb == "STATS") {
+            ostringstream text;
+            METRICS.report(text);
+            reply = text.str() + "END\n";
+        }
+        else if (verb == "COUNT") {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%d\n", currentView()->studentCount);
+            reply = buf;
+        }
+        else if (verb == "PING") {
+            reply = "PONG\n";
+        }
+        else if (verb == "QUIT") {
+            break;
+        }
+        else {
+            reply = "ERROR unknown command\n";
+        }
+        if (!sendAll(fd, reply)) break;
+    }
+    ::close(fd);
+}
+
+/*
+===============================================================================
+FUNCTION: runServer()
+===============================================================================
+Purpose: "serve" command - accept clients on a Unix-domain socket forever
+Logic: Each client gets its own thread (see RideShareServer for how reads
+       and writes are kept apart). Stop the server with Ctrl+C; every
+       registration is already in the change log by the time it is
+       acknowledged, so nothing is lost.
+Parameters:
+  - socketPath: File system path of the socket
+Returns: int - 1 if the socket cannot be created (otherwise never returns)
+*/
+int runServer(const char* socketPath) {
+    signal(SIGPIPE, SIG_IGN); // A client hanging up must not kill the server
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (listener < 0 || strlen(socketPath) >= sizeof(addr.sun_path)) {
+        cout << "[ERROR] Cannot create server socket.\n";
+        return 1;
+    }
+    strcpy(addr.sun_path, socketPath);
+    unlink(socketPath); // Remove a stale socket left by an earlier run
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 128) != 0) {
+        cout << "[ERROR] Cannot listen on " << socketPath << "\n";
+        return 1;
+    }
+
+    static RideShareServer server; // Lives until the process exits
+    server.start();
+    cout << "[Server] " << server.currentView()->studentCount << " students loaded. Listening on "
+         << socketPath << " (Ctrl+C to stop)" << endl; // endl: show it now, even when logging to a file
+
+    while (true) {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0) continue;
+        thread(&RideShareServer::serveConnection, &server, client).detach();
+    }
+}
+
+// Open a connection to a running server. Returns the socket, or -1
+static int connectToServer(const char* socketPath) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (fd < 0 || strlen(socketPath) >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, socketPath);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+===============================================================================
+FUNCTION: runLoadGenerator()
+===============================================================================
+Purpose: "loadgen" command - hammer a running server and report latency
+Logic: Starts 'threads' clients, each with its own connection, each sending
+       'requests' requests one after another. writePercent of them are
+       REGISTER, the rest FIND on the benchmark destinations. Every
+       request's round-trip time is recorded.
+Reports: Total requests per second (QPS) and the p50 / p99 latency
+Returns: int - 0, or 1 if the server cannot be reached
+*/
+int runLoadGenerator(const char* socketPath, int threads, int requests, int writePercent) {
+    signal(SIGPIPE, SIG_IGN);
+    if (threads < 1) threads = 1;
+    if (requests < 1) requests = 1;
+
+    vector<vector<double> > latencies(threads); // Microseconds, one list per thread
+    atomic<int> failures(0);
+
+    struct Client {
+        static void run(const char* socketPath, int id, int requests, int writePercent,
+                        vector<double>* out, atomic<int>* failures) {
+            int fd = connectToServer(socketPath);
+            if (fd < 0) { (*failures)++; return; }
+            LineReader reader(fd);
+            unsigned seed = 1234u + (unsigned)id;
+            out->reserve(requests);
+            string line;
+            for (int r = 0; r < requests; r++) {
+                seed = seed * 1103515245u + 12345u; // Small per-thread random generator
+                bool write = (int)((seed >> 16) % 100) < writePercent;
+                char request[160];
+                const char* dest = BENCH_DESTINATIONS[(seed >> 8) % BENCH_DESTINATION_COUNT];
+                if (write) snprintf(request, sizeof(request), "REGISTER Loadgen %d-%d|%s|Library\n", id, r % 1000, dest);
+                else snprintf(request, sizeof(request), "FIND %s\n", dest);
+
+                chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+                if (!sendAll(fd, request)) { (*failures)++; break; }
+                bool ok = true;
+                if (write) {
+                    ok = reader.readLine(line);
+                }
+                else {
+                    while ((ok = reader.readLine(line)) && line != "END") {}
+                }
+                if (!ok) { (*failures)++; break; }
+                out->push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count());
+            }
+            sendAll(fd, "QUIT\n");
+            ::close(fd);
+        }
+    };
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.push_back(thread(Client::run, socketPath, t, requests, writePercent, &latencies[t], &failures));
+    }
+    for (int t = 0; t < threads; t++) pool[t].join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> all;
+    for (int t = 0; t < threads; t++) all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+    if (all.empty()) {
+        cout << "[ERROR] Could not reach a server on " << socketPath << "\n";
+        return 1;
+    }
+    sort(all.begin(), all.end());
+
+    cout << "threads\t" << threads << "\n";
+    cout << "requests\t" << all.size() << "\t(" << writePercent << "% writes, " << failures.load() << " failed)\n";
+    cout << "qps\t" << (long)(all.size() / seconds) << "\n";
+    cout << "p50_us\t" << all[all.size() / 2] << "\n";
+    cout << "p99_us\t" << all[(size_t)(all.size() * 0.99)] << "\n";
+    return 0;
+}
+
+#else // _WIN32
+
+int runServer(const char*) {
+    cout << "[ERROR] Server mode needs Unix-domain sockets (Linux / macOS).\n";
+    return 1;
+}
+
+int runLoadGenerator(const char*, int, int, int) {
+    cout << "[ERROR] Server mode needs Unix-domain sockets (Linux / macOS).\n";
+    return 1;
+}
+
+#endif
+
+/*
+===============================================================================
+FUNCTION: generateSyntheticStudents()
+===============================================================================
+Purpose: Fill a store with made-up students for benchmarking
+Parameters:
+  - store: Store to add the students to
+  - count: How many students to create
+  - destinations: How many different destinations to spread them over
+  - seed: Random seed, so runs are repeatable
+Returns: void (nothing)
+*/
+void generateSyntheticStudents(StudentStore& store, int count, int destinations, unsigned seed) {
+    RosterSpec spec;
+    spec.students = count;
+    spec.destinations = destinations;
+    spec.seed = seed;
+    RosterGenerator generator(spec);
+    store.reserve(store.size() + count);
+    for (int i = 0; i < count; i++) {
+        StudentForm s;
+        generator.next(i, s);
+        store.add(s);
+    }
+}
+
+/*
+===============================================================================
+FUNCTIONS: RosterGenerator
+===============================================================================
+Destination skew follows a Zipf distribution: destination number k (0 is
+the most popular) is chosen with weight 1 / (k + 1)^skew. skew = 0 spreads
+students evenly; skew = 1 is typical of real rush hours, where a few places
+(Saddar, Hayatabad, the bus stand) get most of the traffic.
+*/
+RosterGenerator::RosterGenerator(const RosterSpec& spec) : spec(spec), rng(spec.seed) {
+    int d = max(1, spec.destinations);
+    cumulative.resize(d);
+    double total = 0;
+    for (int k = 0; k < d; k++) {
+        total += 1.0 / pow(k + 1.0, spec.skew);
+        cumulative[k] = total;
+    }
+}
+
+void RosterGenerator::next(int index, StudentForm& s) {
+    char buf[32];
+
+    // Name: random letters around the requested length, made unique with the index
+    if (spec.nameLength <= 0) {
+        s.name = "Student ";
+    }
+    else {
+        int len = spec.nameLength / 2 + (int)(rng() % (unsigned)(spec.nameLength + 1));
+        s.name.clear();
+        for (int c = 0; c < len; c++) s.name += (char)((c == 0 ? 'A' : 'a') + rng() % 26);
+        s.name += ' ';
+    }
+    snprintf(buf, sizeof(buf), "%d", index);
+    s.name += buf;
+
+    // Destination: Zipf-distributed pick
+    double r = uniform_real_distribution<double>(0.0, cumulative.back())(rng);
+    int dest = (int)(lower_bound(cumulative.begin(), cumulative.end(), r) - cumulative.begin());
+    snprintf(buf, sizeof(buf), "Destination %d", min(dest, (int)cumulative.size() - 1));
+    s.destination = buf;
+    snprintf(buf, sizeof(buf), "Location %d", (int)(rng() % 20));
+    s.currentLocation = buf;
+}
+
+// Milliseconds elapsed since t0
+static double msSince(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+// Read "--name value" from the command line, or return fallback
+static const char* optionValue(int argc, char* argv[], const char* name, const char* fallback) {
+    for (int a = 2; a + 1 < argc; a++) {
+        if (strcmp(argv[a], name) == 0) return argv[a + 1];
+    }
+    return fallback;
+}
+
+// Build a RosterSpec from --students / --destinations / --skew / --name-len / --seed
+static RosterSpec rosterSpecFromArgs(int argc, char* argv[], int defaultStudents) {
+    RosterSpec spec;
+    spec.students = atoi(optionValue(argc, argv, "--students", "0"));
+    if (spec.students <= 0) spec.students = defaultStudents;
+    spec.destinations = max(1, atoi(optionValue(argc, argv, "--destinations", "200")));
+    spec.skew = atof(optionValue(argc, argv, "--skew", "0"));
+    spec.nameLength = atoi(optionValue(argc, argv, "--name-len", "12"));
+    spec.seed = (unsigned)atoi(optionValue(argc, argv, "--seed", "42"));
+    return spec;
+}
+
+/*
+===============================================================================
+FUNCTION: runGenerateCommand()
+===============================================================================
+Purpose: "generate" command - write a synthetic roster file in the
+         Name|Destination|CurrentLocation format of DB_FILE
+Note: Rows are streamed straight to the file, so even very large rosters
+      need almost no memory.
+Returns: int - 0 on success, 1 if the file cannot be written
+*/
+int runGenerateCommand(int argc, char* argv[]) {
+    RosterSpec spec = rosterSpecFromArgs(argc, argv, 100000);
+    const char* path = optionValue(argc, argv, "--out", DB_FILE);
+
+    ofstream outFile(path, ios::trunc);
+    if (!outFile) {
+        cout << "[ERROR] Cannot write " << path << "\n";
+        return 1;
+    }
+    RosterGenerator generator(spec);
+    for (int i = 0; i < spec.students; i++) {
+        StudentForm s;
+        generator.next(i, s);
+        outFile << s.name << "|" << s.destination << "|" << s.currentLocation << "\n";
+    }
+    cout << "Wrote " << spec.students << " students to " << path << "\n";
+    return outFile ? 0 : 1;
+}
+
+/*
+===============================================================================
+FUNCTIONS: RowWriter
+===============================================================================
+*/
+RowWriter::RowWriter(ostream& out, Format format) : out(out), format(format) {
+    buffer.reserve(LIST_BUFFER_BYTES + 1024);
+}
+
+bool RowWriter::parseFormat(const char* text, Format& format) {
+    if (strcmp(text, "pipe") == 0) format = PIPE;
+    else if (strcmp(text, "table") == 0) format = TABLE;
+    else if (strcmp(text, "csv") == 0) format = CSV;
+    else if (strcmp(text, "jsonl") == 0) format = JSONL;
+    else return false;
+    return true;
+}
+
+void RowWriter::header() {
+    if (format == TABLE) {
+        buffer += "#\tName\t\tDestination\tCurrent Location\tLeaves\n";
+        buffer += "-\t----\t\t-----------\t----------------\t------\n";
+    }
+    else if (format == CSV) {
+        buffer += "name,destination,current_location,registered_at,depart_from,depart_until\n";
+    }
+}
+
+void RowWriter::row(long number, const StudentView& s) {
+    char num[24];
+    switch (format) {
+    case PIPE:
+        buffer += s.name; buffer += '|';
+        buffer += s.destination; buffer += '|';
+        buffer += s.currentLocation; buffer += '|';
+        appendNumber(s.registeredAt); buffer += '|';
+        appendNumber(s.departFrom); buffer += '|';
+        appendNumber(s.departUntil); buffer += '\n';
+        break;
+    case TABLE:
+        snprintf(num, sizeof(num), "%ld", number);
+        buffer += num; buffer += '\t';
+        buffer += s.name; buffer += "\t\t";
+        buffer += s.destination; buffer += "\t\t";
+        buffer += s.currentLocation; buffer += "\t\t";
+        if (s.departUntil == 0) {
+            buffer += '-'; // Row written before departure windows existed
+        }
+        else {
+            appendClock(s.departFrom); buffer += '-';
+            appendClock(s.departUntil);
+        }
+        buffer += '\n';
+        break;
+    case CSV:
+        appendCsv(s.name); buffer += ',';
+        appendCsv(s.destination); buffer += ',';
+        appendCsv(s.currentLocation); buffer += ',';
+        appendNumber(s.registeredAt); buffer += ',';
+        appendNumber(s.departFrom); buffer += ',';
+        appendNumber(s.departUntil); buffer += '\n';
+        break;
+    case JSONL:
+        buffer += "{\"name\":"; appendJson(s.name);
+        buffer += ",\"destination\":"; appendJson(s.destination);
+        buffer += ",\"current_location\":"; appendJson(s.currentLocation);
+        buffer += ",\"registered_at\":"; appendNumber(s.registeredAt);
+        buffer += ",\"depart_from\":"; appendNumber(s.departFrom);
+        buffer += ",\"depart_until\":"; appendNumber(s.departUntil);
+        buffer += "}\n";
+        break;
+    }
+    if (buffer.size() >= LIST_BUFFER_BYTES) flush();
+}
+
+void RowWriter::flush() {
+    if (buffer.empty()) return;
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+    buffer.clear(); // Keeps its memory for the next chunk
+}
+
+// Quote the field only if it holds a comma, quote or line break ("" = one quote)
+void RowWriter::appendCsv(const char* field) {
+    if (strpbrk(field, ",\"\r\n") == NULL) {
+        buffer += field;
+        return;
+    }
+    buffer += '"';
+    for (const char* c = field; *c; c++) {
+        if (*c == '"') buffer += '"';
+        buffer += *c;
+    }
+    buffer += '"';
+}
+
+void RowWriter::appendNumber(uint32_t value) {
+    char digits[16];
+    snprintf(digits, sizeof(digits), "%u", value);
+    buffer += digits;
+}
+
+void RowWriter::appendClock(uint32_t when) {
+    time_t t = (time_t)when;
+    char text[16];
+    strftime(text, sizeof(text), "%H:%M", localtime(&t));
+    buffer += text;
+}
+
+// JSON string: escape quotes, backslashes and control characters
+void RowWriter::appendJson(const char* field) {
+    buffer += '"';
+    for (const char* c = field; *c; c++) {
+        unsigned char ch = (unsigned char)*c;
+        if (ch == '"' || ch == '\\') {
+            buffer += '\\';
+            buffer += *c;
+        }
+        else if (ch < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", ch);
+            buffer += esc;
+        }
+        else {
+            buffer += *c;
+        }
+    }
+    buffer += '"';
+}
+
+/*
+===============================================================================
+FUNCTION: streamStudentList()
+===============================================================================
+Purpose: List students page by page straight from the files
+How it works:
+  1. Read the change log (it is short: compaction keeps it so) into an
+     "overlay": the latest state of every student it mentions.
+  2. Walk the snapshot one record at a time: the mapped BIN_FILE if it is
+     current, otherwise DB_FILE line by line. A student in the overlay is
+     shown with their logged details (or skipped if deleted).
+  3. Finally show students that only exist in the log, in log order.
+  Rows are filtered and counted as they go, and reading stops as soon as
+  'limit' rows are written, so the first page never waits for the rest of
+  the file. Students appear in file order, updated ones in place.
+Parameters:
+  - options: offset / limit / destination filter / format
+  - out: Where to write (cout for the command line)
+Returns: long - Rows written
+*/
+long streamStudentList(const ListOptions& options, ostream& out) {
+    // Step 1: The change log overlay
+    struct Logged {
+        StudentForm student;
+        bool alive;  // false = deleted
+        bool placed; // Already shown in place of its snapshot row
+        bool deleted; // Deleted at some point (a later registration's spelling of the name wins)
+    };
+    vector<Logged> logged;                // In order of first mention
+    unordered_map<string, size_t> latest; // lower-cased name -> slot in 'logged'
+    ifstream logFile(LOG_FILE);
+    string line;
+    vector<string> fields;
+    while (logFile && getline(logFile, line)) {
+        splitImportLine(line, '|', fields);
+        bool upsert = fields[0] == "U" && (fields.size() == 4 || fields.size() == 7);
+        if (!upsert && !(fields[0] == "D" && fields.size() == 2)) continue; // Damaged line
+
+        string key = normalizeKey(fields[1].c_str());
+        unordered_map<string, size_t>::iterator it = latest.find(key);
+        if (it == latest.end()) {
+            it = latest.insert(make_pair(key, logged.size())).first;
+            logged.push_back(Logged());
+            logged.back().alive = false;
+            logged.back().placed = false;
+            logged.back().deleted = false;
+            logged.back().student.name = fields[1];
+        }
+        Logged& entry = logged[it->second];
+        if (upsert) {
+            // Like the store: an update keeps the name as first registered
+            if (entry.deleted && !entry.alive) entry.student.name = fields[1];
+            entry.student.destination = fields[2];
+            entry.student.currentLocation = fields[3];
+            bool timed = fields.size() == 7;
+            entry.student.registeredAt = timed ? (uint32_t)strtoul(fields[4].c_str(), NULL, 10) : 0;
+            entry.student.departFrom = timed ? (uint32_t)strtoul(fields[5].c_str(), NULL, 10) : 0;
+            entry.student.departUntil = timed ? (uint32_t)strtoul(fields[6].c_str(), NULL, 10) : 0;
+        }
+        else {
+            entry.deleted = true;
+        }
+        entry.alive = upsert;
+    }
+
+    // Filtering, paging and writing, shared by every source below
+    struct Pager {
+        const ListOptions& options;
+        RowWriter writer;
+        uint32_t now;
+        long matched, written;
+
+        Pager(const ListOptions& options, ostream& out)
+            : options(options), writer(out, options.format), now(nowSeconds()), matched(0), written(0) {}
+        bool full() const { return options.limit >= 0 && written >= options.limit; }
+        void offer(const StudentView& s) {
+            if (full()) return;
+            // Expired requests are skipped, like the store drops them (0 = no times in the file yet)
+            if (s.departUntil != 0 && s.departUntil < now) return;
+            if (!options.destination.empty() && strcasecmp(s.destination, options.destination.c_str()) != 0) return;
+            if (matched++ < options.offset) return;
+            written++;
+            writer.row(matched, s);
+        }
+        // Show the snapshot row, or the logged version of that student instead
+        void offerSnapshotRow(const StudentView& s, vector<Logged>& logged,
+                              const unordered_map<string, size_t>& latest) {
+            if (!latest.empty()) {
+                unordered_map<string, size_t>::const_iterator it = latest.find(normalizeKey(s.name));
+                if (it != latest.end()) {
+                    Logged& entry = logged[it->second];
+                    if (entry.placed) return; // Duplicate name in the snapshot
+                    entry.placed = true;
+                    if (entry.alive) {
+                        StudentView shown = viewOf(entry.student);
+                        if (!entry.deleted) shown.name = s.name;
+                        offer(shown);
+                    }
+                    return;
+                }
+            }
+            offer(s);
+        }
+    };
+    Pager pager(options, out);
+    pager.writer.header();
+
+    // Step 2: The snapshot, one record at a time
+    BinarySnapshot snapshot;
+    ShardManifest manifest;
+    bool sharded = isShardedLayout() && manifest.read(MANIFEST_FILE);
+    if (!sharded && isBinarySnapshotCurrent() && snapshot.open(BIN_FILE)) {
+        if (!options.destination.empty() && latest.empty()) {
+            // Nothing logged: the destination directory lists exactly the rows we need
+            const uint32_t* ids;
+            int n = snapshot.findByDestination(options.destination.c_str(), &ids);
+            for (int m = 0; m < n && !pager.full(); m++) {
+                pager.offer(snapshot.view(ids[m]));
+            }
+        }
+        else {
+            for (int i = 0; i < snapshot.count() && !pager.full(); i++) {
+                pager.offerSnapshotRow(snapshot.view(i), logged, latest);
+            }
+        }
+    }
+    else {
+        /*
+        The text files, one chunk at a time (see RecordLoader). With --dest
+        on a sharded database only its shard can hold matching rows: a
+        student the log moved there from another shard is shown in Step 3.
+        */
+        vector<string> files;
+        if (!sharded) files.push_back(DB_FILE);
+        else if (options.destination.empty()) files = manifest.files;
+        else files.push_back(manifest.files[shardOf(normalizeKey(options.destination.c_str()), manifest.shardCount())]);
+
+        RecordLoader loader(files, 1);
+        for (size_t k = 0; !pager.full(); k++) {
+            RecordChunk* chunk = loader.waitFor(k);
+            if (chunk == NULL) break;
+            for (size_t r = 0; r < chunk->rows.size() && !pager.full(); r++) {
+                pager.offerSnapshotRow(chunk->rows[r], logged, latest);
+            }
+            loader.release(k);
+        }
+    }
+
+    // Step 3: Students who are only in the log
+    for (size_t e = 0; e < logged.size() && !pager.full(); e++) {
+        if (logged[e].alive && !logged[e].placed) {
+            pager.offer(viewOf(logged[e].student));
+        }
+    }
+    return pager.written; // The RowWriter flushes when 'pager' goes away
+}
+
+/*
+===============================================================================
+FUNCTION: commandList()
+===============================================================================
+Purpose: "list" command - streamed listing with paging and filtering
+Options:
+  --dest D            Only students going to D (any case)
+  --offset N          Skip the first N matching students
+  --limit N           Show at most N students
+  --page P            Show page P (1 = first); pages are --page-size long (default 50)
+  --format F          pipe (default), table, csv or jsonl
+Returns: int - 0 on success, 1 on bad options
+*/
+int commandList(int argc, char* argv[]) {
+    ListOptions options;
+    options.destination = optionValue(argc, argv, "--dest", "");
+    options.offset = max(0L, atol(optionValue(argc, argv, "--offset", "0")));
+    options.limit = atol(optionValue(argc, argv, "--limit", "-1"));
+
+    long page = atol(optionValue(argc, argv, "--page", "0"));
+    if (page > 0) {
+        long pageSize = max(1L, atol(optionValue(argc, argv, "--page-size", "50")));
+        options.offset = (page - 1) * pageSize;
+        options.limit = pageSize;
+    }
+    if (!RowWriter::parseFormat(optionValue(argc, argv, "--format", "pipe"), options.format)) {
+        cout << "[ERROR] --format must be pipe, table, csv or jsonl.\n";
+        return 1;
+    }
+
+    streamStudentList(options, cout);
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: runListBenchmark()
+===============================================================================
+Purpose: "bench-list" - compare listing by loading the whole roster first
+         (the old way) with streamStudentList(), at 10k, 100k and 1M students
+Measures:
+  load_first_row_ms    load the store, then format the first row
+  stream_first_row_ms  stream just the first row (--limit 1)
+  stream_page_ms       stream page 100 (50 rows) filtered by destination
+  load_list_ms         load + write every row field by field (menu style)
+  stream_list_ms       stream every row through the RowWriter
+Full listings go to a scratch file, so the terminal is not part of the timing.
+Returns: int - 0
+*/
+int runListBenchmark() {
+    const int sizes[] = { 10000, 100000, 1000000 };
+    const char* realDb = DB_FILE;
+    const char* realLog = LOG_FILE;
+    const char* realBin = BIN_FILE;
+    const char* realManifest = MANIFEST_FILE;
+    DB_FILE = "ride_share_bench.txt";
+    LOG_FILE = "ride_share_bench.log";
+    BIN_FILE = "ride_share_bench.bin";
+    MANIFEST_FILE = "ride_share_bench.manifest"; // Never created: the benchmark database is not sharded
+    const char* outPath = "ride_share_bench.out";
+    remove(LOG_FILE);
+    remove(BIN_FILE);
+
+    cout << "students\tload_first_row_ms\tstream_first_row_ms\tstream_page_ms\tload_list_ms\tstream_list_ms\n";
+    for (int n = 0; n < 3; n++) {
+        {
+            RosterSpec spec;
+            spec.students = sizes[n];
+            RosterGenerator generator(spec);
+            ofstream roster(DB_FILE);
+            StudentForm s;
+            for (int i = 0; i < spec.students; i++) {
+                generator.next(i, s);
+                roster << s.name << "|" << s.destination << "|" << s.currentLocation << "\n";
+            }
+        }
+
+        // Old: everything is loaded before the first row can be shown
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        double loadFirst, loadList;
+        {
+            StudentStore store;
+            loadStudentsFromFile(store);
+            ostringstream first;
+            first << 1 << "\t" << store.at(0).name << "\t\t" << store.at(0).destination << "\n";
+            loadFirst = msSince(t0);
+
+            ofstream listing(outPath);
+            for (int i = 0; i < store.size(); i++) {
+                StudentView s = store.at(i);
+                listing << (i + 1) << "\t" << s.name << "\t\t" << s.destination << "\t\t"
+                        << s.currentLocation << "\n";
+            }
+            loadList = msSince(t0);
+        }
+
+        ListOptions options;
+        options.format = RowWriter::TABLE;
+        options.limit = 1;
+        ostringstream first;
+        t0 = chrono::steady_clock::now();
+        streamStudentList(options, first);
+        double streamFirst = msSince(t0);
+
+        options.destination = "Destination 7";
+        options.offset = 99 * 50;
+        options.limit = 50;
+        ostringstream page;
+        t0 = chrono::steady_clock::now();
+        streamStudentList(options, page);
+        double streamPage = msSince(t0);
+
+        ListOptions all;
+        all.format = RowWriter::TABLE;
+        t0 = chrono::steady_clock::now();
+        {
+            ofstream listing(outPath);
+            streamStudentList(all, listing);
+        }
+        double streamList = msSince(t0);
+
+        cout << sizes[n] << "\t" << loadFirst << "\t" << streamFirst << "\t" << streamPage << "\t"
+             << loadList << "\t" << streamList << "\n";
+    }
+
+    remove(DB_FILE);
+    remove(outPath);
+    DB_FILE = realDb;
+    LOG_FILE = realLog;
+    BIN_FILE = realBin;
+    MANIFEST_FILE = realManifest;
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: runExpiryBenchmark()
+===============================================================================
+Purpose: "bench-expiry" - show that memory stays flat under a never-ending
+         stream of registrations, because expired requests are dropped
+How it works: a simulated clock starts now and moves 1 second per
+  REGISTRATIONS_PER_SECOND registrations (every name is new). Each request
+  is open for 30 minutes from when it is made; the store's expire() runs
+  once per simulated second, like the server writer does. Every 10
+  simulated minutes a line is printed.
+Columns:
+  registered   registrations so far
+  minutes      simulated time
+  live         students currently in the store
+  memory_mb    StudentStore::memoryBytes()
+  expired      requests removed so far
+  expire_ms    total time spent in expire() so far
+  register_ns  average cost of one add() in the last 10 minutes
+Returns: int - 0
+*/
+int runExpiryBenchmark() {
+    const int REGISTRATIONS_PER_SECOND = 200;
+    const int WINDOW_MIN = 30;
+    const int MINUTES = 180;
+    const int REPORT_EVERY_MIN = 10;
+
+    StudentStore store;
+    RosterSpec spec;
+    spec.students = REGISTRATIONS_PER_SECOND * 60 * MINUTES;
+    RosterGenerator generator(spec);
+    StudentForm s;
+    uint32_t start = nowSeconds();
+    long registered = 0, expired = 0;
+    double expireMs = 0, addMs = 0;
+
+    cout << "registered\tminutes\tlive\tmemory_mb\texpired\texpire_ms\tregister_ns\n";
+    for (int second = 1; second <= MINUTES * 60; second++) {
+        uint32_t simNow = start + second;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (int r = 0; r < REGISTRATIONS_PER_SECOND; r++) {
+            generator.next((int)registered++, s);
+            s.registeredAt = s.departFrom = simNow;
+            s.departUntil = simNow + WINDOW_MIN * 60;
+            store.add(s);
+        }
+        addMs += msSince(t0);
+
+        t0 = chrono::steady_clock::now();
+        expired += store.expire(simNow);
+        expireMs += msSince(t0);
+
+        if (second % (REPORT_EVERY_MIN * 60) == 0) {
+            cout << registered << "\t" << second / 60 << "\t" << store.size() << "\t"
+                 << store.memoryBytes() / (1024.0 * 1024.0) << "\t" << expired << "\t" << expireMs << "\t"
+                 << addMs * 1e6 / (REGISTRATIONS_PER_SECOND * 60.0 * REPORT_EVERY_MIN) << "\n";
+            addMs = 0;
+        }
+    }
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: runStatsBenchmark()
+===============================================================================
+Purpose: "bench-stats" - what collecting the Metrics costs on the hot paths
+How it works: on a 100k-student scratch roster, each workload runs with
+  METRICS.enabled off and on, interleaved, 30 times each; the fastest run
+  of each is kept so noise from the machine counts as little as possible.
+Workloads:
+  load    loadStudentsFromFile() (includes parsing every line)
+  save    saveAllStudentsToFile()
+  lookup  1M findByDestination() calls
+  upsert  10k upsertStudent() calls moving students between destinations
+Returns: int - 0
+*/
+int runStatsBenchmark() {
+    const int STUDENTS = 100000;
+    const int LOOKUPS = 1000000;
+    const int UPSERTS = 10000;
+    const int ROUNDS = 30;
+
+    const char* realDb = DB_FILE;
+    const char* realLog = LOG_FILE;
+    const char* realBin = BIN_FILE;
+    const char* realManifest = MANIFEST_FILE;
+    DB_FILE = "ride_share_bench.txt";
+    LOG_FILE = "ride_share_bench.log";
+    BIN_FILE = "ride_share_bench.bin";
+    MANIFEST_FILE = "ride_share_bench.manifest"; // Never created: the benchmark database is not sharded
+    remove(LOG_FILE);
+    remove(BIN_FILE);
+
+    RosterSpec spec;
+    spec.students = STUDENTS;
+    spec.nameLength = 12;
+    {
+        StudentStore seedStore;
+        RosterGenerator generator(spec);
+        StudentForm s;
+        for (int i = 0; i < spec.students; i++) {
+            generator.next(i, s);
+            seedStore.add(s);
+        }
+        saveAllStudentsToFile(seedStore);
+    }
+
+    // Lookup keys and upserts are prepared once, outside the timing
+    vector<string> keys(spec.destinations);
+    for (int d = 0; d < spec.destinations; d++) keys[d] = "Destination " + to_string(d);
+    vector<StudentForm> moves(UPSERTS);
+    {
+        RosterGenerator generator(spec);
+        for (int i = 0; i < UPSERTS; i++) generator.next(i, moves[i]); // Same names as the roster
+    }
+
+    enum { LOAD, SAVE, LOOKUP, UPSERT, WORKLOADS };
+    const char* names[WORKLOADS] = { "load", "save", "lookup", "upsert" };
+    double best[WORKLOADS][2];
+    for (int w = 0; w < WORKLOADS; w++) best[w][0] = best[w][1] = 1e300;
+
+    StudentStore store;
+    ChangeLog changeLog(LOG_FILE);
+    long sink = 0;
+    for (int round = 0; round < ROUNDS * 2; round++) {
+        int on = ((round + 1) / 2) % 2; // off, on, on, off, off, on, ...: neither always goes first
+        METRICS.enabled = on != 0;
+        chrono::steady_clock::time_point t0;
+
+        store.clear();
+        t0 = chrono::steady_clock::now();
+        loadStudentsFromFile(store);
+        best[LOAD][on] = min(best[LOAD][on], msSince(t0));
+
+        t0 = chrono::steady_clock::now();
+        saveAllStudentsToFile(store);
+        best[SAVE][on] = min(best[SAVE][on], msSince(t0));
+
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < LOOKUPS; q++) {
+            const vector<int>* ids = store.findByDestination(keys[q % keys.size()].c_str());
+            if (ids != NULL) sink += (long)ids->size();
+        }
+        best[LOOKUP][on] = min(best[LOOKUP][on], msSince(t0));
+
+        changeLog.reset();
+        t0 = chrono::steady_clock::now();
+        for (int u = 0; u < UPSERTS; u++) {
+            moves[u].destination = keys[(u + round) % keys.size()];
+            upsertStudent(store, changeLog, moves[u]);
+        }
+        best[UPSERT][on] = min(best[UPSERT][on], msSince(t0));
+    }
+    METRICS.enabled = true;
+
+    cout << "op\toff_ms\ton_ms\toverhead_pct\n";
+    for (int w = 0; w < WORKLOADS; w++) {
+        cout << names[w] << "\t" << best[w][0] << "\t" << best[w][1] << "\t"
+             << (best[w][1] - best[w][0]) * 100.0 / best[w][0] << "\n";
+    }
+    if (sink < 0) cout << sink; // Keeps the lookups from being optimized away
+
+    remove(DB_FILE);
+    remove(LOG_FILE);
+    DB_FILE = realDb;
+    LOG_FILE = realLog;
+    BIN_FILE = realBin;
+    MANIFEST_FILE = realManifest;
+    return 0;
+}
+
+/*
+===============================================================================
+FUNCTION: runBenchmarkSuite()
+===============================================================================
+Purpose: "bench" command - time each database operation separately on a
+         synthetic roster, so a slowdown in one of them shows up clearly
+         when results from two versions are compared
+Operations timed (each on its own, without screen output):
+  load     loadStudentsFromFile() on the generated file
+  save     saveAllStudentsToFile() of the whole roster
+  register upsertStudent() of brand-new students (includes the log append)
+  update   upsertStudent() of existing students moving destination
+  find     destination lookups, visiting every match
+  scan     full-roster destination scans comparing key ids
+  list     formatting every student the way "list" prints them
+--changes N sets how many register / update operations are timed
+(default: a tenth of the roster, at most 10000).
+Output: one JSON object per line (or tab-separated with --format tsv):
+  {"op":"load","students":100000,"count":100000,"ms":41.2,"per_second":2427184}
+The benchmark works on its own files (ride_share_bench.*), never on the
+real database, and deletes them at the end.
+Returns: int - 0
+*/
+int runBenchmarkSuite(int argc, char* argv[]) {
+    RosterSpec spec = rosterSpecFromArgs(argc, argv, 100000);
+    bool tsv = strcmp(optionValue(argc, argv, "--format", "json"), "tsv") == 0;
+    int changes = atoi(optionValue(argc, argv, "--changes", "0")); // Register / update operations
+    if (changes <= 0) changes = max(1, min(10000, spec.students / 10));
+    const int queries = 1000;
+
+    // Point the program at scratch files for the duration of the benchmark
+    const char* realDb = DB_FILE;
+    const char* realLog = LOG_FILE;
+    const char* realBin = BIN_FILE;
+    const char* realManifest = MANIFEST_FILE;
+    DB_FILE = "ride_share_bench.txt";
+    LOG_FILE = "ride_share_bench.log";
+    BIN_FILE = "ride_share_bench.bin";
+    MANIFEST_FILE = "ride_share_bench.manifest"; // Never created: the benchmark database is not sharded
+    remove(LOG_FILE);
+    remove(BIN_FILE);
+
+    // Write the roster file (not timed)
+    {
+        StudentStore seedStore;
+        RosterGenerator generator(spec);
+        seedStore.reserve(spec.students);
+        for (int i = 0; i < spec.students; i++) {
+            StudentForm s;
+            generator.next(i, s);
+            seedStore.add(s);
+        }
+        saveAllStudentsToFile(seedStore);
+    }
+
+    if (tsv) cout << "op\tstudents\tcount\tms\tper_second\n";
+    struct Report {
+        static void line(bool tsv, const char* op, int students, long count, double ms) {
+            long perSecond = (long)(count / (ms > 0 ? ms / 1000.0 : 1e-9));
+            if (tsv) {
+                cout << op << "\t" << students << "\t" << count << "\t" << ms << "\t" << perSecond << "\n";
+            }
+            else {
+                cout << "{\"op\":\"" << op << "\",\"students\":" << students << ",\"count\":" << count
+                     << ",\"ms\":" << ms << ",\"per_second\":" << perSecond << "}\n";
+            }
+        }
+    };
+    chrono::steady_clock::time_point t0;
+
+    // load
+    StudentStore store;
+    t0 = chrono::steady_clock::now();
+    int loaded = loadStudentsFromFile(store);
+    Report::line(tsv, "load", spec.students, loaded, msSince(t0));
+
+    // save
+    t0 = chrono::steady_clock::now();
+    saveAllStudentsToFile(store);
+    Report::line(tsv, "save", spec.students, store.size(), msSince(t0));
+
+    // register (new students)
+    ChangeLog changeLog(LOG_FILE);
+    RosterSpec extraSpec = spec;
+    extraSpec.seed = spec.seed + 1;
+    RosterGenerator extra(extraSpec);
+    t0 = chrono::steady_clock::now();
+    for (int c = 0; c < changes; c++) {
+        StudentForm s;
+        extra.next(spec.students + c, s);
+        upsertStudent(store, changeLog, s);
     }
+    Report::line(tsv, "register", spec.students, changes, msSince(t0));
 
-    // Return 0 to operating system indicating successful program completion
-    return 0;
-}
+    // update (existing students change destination)
+    t0 = chrono::steady_clock::now();
+    for (int c = 0; c < changes; c++) {
+        StudentView current = store.at((int)(((long long)c * 7919) % store.size()));
+        StudentForm s;
+        s.name = current.name;
+        s.currentLocation = current.currentLocation;
+        char dest[32];
+        snprintf(dest, sizeof(dest), "Destination %d", c % spec.destinations);
+        s.destination = dest;
+        upsertStudent(store, changeLog, s);
+    }
+    Report::line(tsv, "update", spec.students, changes, msSince(t0));
 
-/*
-===============================================================================
-FUNCTION: showMenu()
-===============================================================================
-Purpose: Display the menu options to the user
-Parameters: None
-Returns: void (nothing)
-*/
-void showMenu() {
-    cout << "\n=== UNIVERSITY RIDE SHARE SYSTEM ===\n";
-    cout << "1. Register / Update My Location\n";
-    cout << "2. Find Students Going to My Destination\n";
-    cout << "3. View All Registered Students\n";
-    cout << "4. Clear All Data\n";
-    cout << "5. Exit\n";
+    // find
+    long hits = 0;
+    t0 = chrono::steady_clock::now();
+    for (int q = 0; q < queries; q++) {
+        char dest[50];
+        snprintf(dest, sizeof(dest), "destination %d", q % spec.destinations);
+        const vector<int>* matches = store.findByDestination(dest);
+        if (matches == NULL) continue;
+        for (size_t m = 0; m < matches->size(); m++) hits += store.at((*matches)[m]).name[0] != '\0';
+    }
+    Report::line(tsv, "find", spec.students, queries, msSince(t0));
+
+    // scan (visit every record, comparing destinations by key id)
+    const int scans = 20;
+    long scanHits = 0, expectedHits = 0;
+    t0 = chrono::steady_clock::now();
+    for (int q = 0; q < scans; q++) {
+        char dest[50];
+        snprintf(dest, sizeof(dest), "destination %d", q % spec.destinations);
+        int key = store.findDestinationKey(dest);
+        for (int i = 0; i < store.size(); i++) scanHits += store.destinationKey(i) == (uint32_t)key;
+    }
+    Report::line(tsv, "scan", spec.students, scans, msSince(t0));
+    for (int q = 0; q < scans; q++) {
+        char dest[50];
+        snprintf(dest, sizeof(dest), "destination %d", q % spec.destinations);
+        const vector<int>* matches = store.findByDestination(dest);
+        if (matches != NULL) expectedHits += (long)matches->size();
+    }
+    if (scanHits != expectedHits) {
+        cout << "[ERROR] Scan and index disagree (" << scanHits << " vs " << expectedHits << ")\n";
+    }
+
+    // list
+    t0 = chrono::steady_clock::now();
+    ostringstream listing;
+    for (int i = 0; i < store.size(); i++) {
+        StudentView s = store.at(i);
+        listing << s.name << "|" << s.destination << "|" << s.currentLocation << "\n";
+    }
+    Report::line(tsv, "list", spec.students, store.size(), msSince(t0));
+
+    // memory (records + names + places + destination index, not a timing)
+    size_t bytes = store.memoryBytes();
+    if (tsv) {
+        cout << "# memory\t" << store.size() << "\t" << bytes << "\t" << bytes / max(1, store.size()) << "\n";
+    }
+    else {
+        cout << "{\"op\":\"memory\",\"students\":" << store.size() << ",\"bytes\":" << bytes
+             << ",\"bytes_per_student\":" << bytes / max(1, store.size()) << "}\n";
+    }
+
+    // Clean up and restore the real file names
+    remove(DB_FILE);
+    remove(LOG_FILE);
+    remove(BIN_FILE);
+    DB_FILE = realDb;
+    LOG_FILE = realLog;
+    BIN_FILE = realBin;
+    MANIFEST_FILE = realManifest;
+    return (hits >= 0 && scanHits == expectedHits) ? 0 : 1;
 }
 
 /*
 ===============================================================================
-FUNCTION: ensureFileExists()
+FUNCTION: runIndexBenchmark()
 ===============================================================================
-Purpose: Create the database file if it doesn't exist
-Why needed: Program needs this file to store student data permanently
+Purpose: Compare finding ride partners with the destination index against
+         the old linear strcasecmp() scan and a linear scan comparing
+         destination key ids, at 10k, 100k and 1M students
 Parameters: None
-Returns: void (nothing)
+Returns: int - 0 (used as the program's exit code)
 */
-void ensureFileExists() {
-    // Try to open file for reading (input file stream)
-    ifstream testFile(DB_FILE);
-    
-    // If file doesn't exist or can't be opened
-    if (!testFile) {
-        // Create the file by opening it in output mode
-        // Opening with ofstream automatically creates the file if it doesn't exist
-        ofstream createFile(DB_FILE);
-        
-        if (createFile) {
-            createFile.close(); // Close the file (good practice)
-            cout << "[System] Database file created successfully.\n";
-        } 
-        else {
-            // Error: Can't create file (maybe no write permissions)
-            cout << "[ERROR] Cannot create database file. Check folder permissions!\n";
-            cout << "[INFO] Trying alternative location...\n";
-            // Could try a different path here (e.g., user's home directory)
+int runIndexBenchmark() {
+    const int sizes[] = { 10000, 100000, 1000000 };
+    const int destinations = 200; // Distinct destinations in the synthetic roster
+    const int queries = 200;      // Lookups timed per method
+
+    cout << "students\tscan_us_per_query\tkey_scan_us_per_query\tindex_us_per_query\tspeedup\n";
+    for (int n = 0; n < 3; n++) {
+        StudentStore store;
+        generateSyntheticStudents(store, sizes[n], destinations, 42);
+
+        // Same query list for both methods
+        vector<string> targets;
+        for (int q = 0; q < queries; q++) {
+            char buf[50];
+            snprintf(buf, sizeof(buf), "DESTINATION %d", (q * 7) % destinations);
+            targets.push_back(buf);
         }
-    } 
-    else {
-        // File already exists, just close it
-        testFile.close();
+
+        // Old way: compare every student's destination
+        long scanHits = 0;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            for (int i = 0; i < store.size(); i++) {
+                if (strcasecmp(store.at(i).destination, targets[q].c_str()) == 0) scanHits++;
+            }
+        }
+        double scanUs = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count() / queries;
+
+        // Still a scan, but each record is one integer compare (see PlacePool)
+        long keyHits = 0;
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            int key = store.findDestinationKey(targets[q].c_str());
+            for (int i = 0; i < store.size(); i++) {
+                if (store.destinationKey(i) == (uint32_t)key) keyHits++;
+            }
+        }
+        double keyScanUs = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count() / queries;
+
+        // New way: jump straight to the matching students
+        long indexHits = 0;
+        t0 = chrono::steady_clock::now();
+        for (int q = 0; q < queries; q++) {
+            const vector<int>* matches = store.findByDestination(targets[q].c_str());
+            if (matches == NULL) continue;
+            for (size_t m = 0; m < matches->size(); m++) {
+                if (store.at((*matches)[m]).name[0] != '\0') indexHits++;
+            }
+        }
+        double indexUs = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count() / queries;
+
+        if (scanHits != indexHits || keyHits != indexHits) {
+            cout << "[ERROR] Index and scan disagree (" << indexHits << " vs " << scanHits
+                 << " vs " << keyHits << ")\n";
+            return 1;
+        }
+        cout << sizes[n] << "\t" << scanUs << "\t" << keyScanUs << "\t" << indexUs << "\t"
+             << (scanUs / indexUs) << "x\n";
     }
+    return 0;
 }
 
 /*
 ===============================================================================
-FUNCTION: loadStudentsFromFile()
+FUNCTION: runLoadBenchmark()
 ===============================================================================
-Purpose: Read all student records from the database file into an array
-Parameters: 
-  - arr[]: Array to store the students
-  - maxSize: Maximum number of students the array can hold
-Returns: int - Number of students actually loaded
-File Format: Each line is: Name|Destination|CurrentLocation
-Example: John Smith|Saddar|Library
+Purpose: Time a cold start from the text database against the binary snapshot
+Measures:
+  1. Text: parse DB_FILE into a StudentStore
+  2. Binary in place: map BIN_FILE and answer one destination query from it
+  3. Binary to store: map BIN_FILE and copy every record into a StudentStore
+Parameters: None
+Returns: int - 0 on success, 1 if a file is missing
 */
-int loadStudentsFromFile(Student arr[], int maxSize) {
-    // Open file for reading
-    ifstream inFile(DB_FILE);
-    
-    // If file doesn't exist or can't be opened, return 0 (no students loaded)
-    if (!inFile) {
-        return 0;
+int runLoadBenchmark() {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    StudentStore textStore;
+    int textCount = loadStudentsFromFile(textStore);
+    double textMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    if (textCount == 0) {
+        cout << "[ERROR] " << DB_FILE << " is empty or missing.\n";
+        return 1;
     }
 
-    int count = 0;        // Counter for number of students loaded
-    char line[300];       // Buffer to store each line (max 300 characters)
-
-    /*
-    Read file line by line until:
-    1. End of file is reached, OR
-    2. We've loaded maxSize students (array is full)
-    */
-    while (inFile.getline(line, 300) && count < maxSize) {
-        // Skip empty lines
-        if (strlen(line) == 0) continue;
-        
-        // Temporary arrays to store the parsed data
-        char d_name[50], d_dest[50], d_loc[50];
-        
-        /*
-        Parse the line character by character
-        part: Which field we're currently reading (0=name, 1=destination, 2=location)
-        j: Index for writing into current field array
-        */
-        int part = 0, j = 0;
-        
-        // Loop through each character in the line
-        for (int i = 0; line[i] != '\0'; i++) {
-            // If we encounter the delimiter '|', move to next field
-            if (line[i] == '|') {
-                // Null-terminate the current field
-                if(part == 0) d_name[j] = '\0';
-                else if(part == 1) d_dest[j] = '\0';
-                
-                part++; // Move to next field
-                j = 0;  // Reset index for next field
-            } 
-            else {
-                // Add character to appropriate field based on 'part'
-                if(part == 0) d_name[j++] = line[i];      // Building name
-                else if(part == 1) d_dest[j++] = line[i]; // Building destination
-                else if(part == 2) d_loc[j++] = line[i];  // Building location
-            }
-        }
-        // Null-terminate the last field (location)
-        d_loc[j] = '\0';
+    // Query the destination of the first student so there is always a match
+    string target = textStore.at(0).destination;
 
-        /*
-        Copy the parsed data into the array
-        strcpy() = string copy function
-        Copies from source (d_name) to destination (arr[count].name)
-        */
-        strcpy(arr[count].name, d_name);
-        strcpy(arr[count].destination, d_dest);
-        strcpy(arr[count].currentLocation, d_loc);
-        
-        count++; // Increment student count
+    t0 = chrono::steady_clock::now();
+    BinarySnapshot snapshot;
+    if (!snapshot.open(BIN_FILE)) {
+        cout << "[ERROR] " << BIN_FILE << " not found. Run \"convert\" first.\n";
+        return 1;
     }
+    const uint32_t* ids;
+    int matches = snapshot.findByDestination(target.c_str(), &ids);
+    double inPlaceMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    snapshot.close();
 
-    inFile.close(); // Close the file (good practice)
-    return count;   // Return number of students loaded
+    t0 = chrono::steady_clock::now();
+    StudentStore binStore;
+    BinarySnapshot snapshot2;
+    snapshot2.open(BIN_FILE);
+    int binCount = loadStudentsFromBinary(binStore, snapshot2);
+    double binMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    cout << "students\t" << textCount << "\n";
+    cout << "text_load_ms\t" << textMs << "\n";
+    cout << "binary_open_and_query_ms\t" << inPlaceMs << "\t(" << matches << " matches for '" << target << "')\n";
+    cout << "binary_load_to_store_ms\t" << binMs << "\t(" << binCount << " students)\n";
+    return 0;
 }
 
 /*
 ===============================================================================
-FUNCTION: saveAllStudentsToFile()
+FUNCTION: generateMappedStudents()
 ===============================================================================
-Purpose: Write all students from the array to the database file
-Note: This OVERWRITES the entire file with current data
+Purpose: Fill a store with made-up students whose places all have
+         coordinates, for the proximity and ride group benchmarks
+Logic: Creates "Spot N" places scattered up to 1 km around well-known
+       places, so students are not all stacked on the exact same point,
+       then gives each student a random destination and spot.
 Parameters:
-  - arr[]: Array containing all students
-  - count: Number of students in the array
-Returns: void (nothing)
+  - store: Store to add the students to
+  - count: How many students to create
+  - seed: Random seed, so runs are repeatable
 */
-void saveAllStudentsToFile(Student arr[], int count) {
-    // Open file for writing (output mode)
-    // This automatically OVERWRITES the existing file
-    ofstream outFile(DB_FILE);
-    
-    // Check if file opened successfully
-    if (!outFile) {
-        cout << "[ERROR] Cannot write to database file!\n";
-        cout << "[INFO] Make sure the program has write permissions.\n";
-        return; // Exit function early
+void generateMappedStudents(StudentStore& store, int count, unsigned seed) {
+    srand(seed);
+    int spots = BENCH_LOCATION_COUNT * BENCH_SPOTS_PER_LOCATION;
+    for (int i = 0; i < spots; i++) {
+        char place[50];
+        snprintf(place, sizeof(place), "Spot %d", i);
+        Point p;
+        CAMPUS_PLACES.lookup(BENCH_LOCATIONS[i % BENCH_LOCATION_COUNT], p);
+        CAMPUS_PLACES.set(place, p.x + (rand() % 1000) / 500.0 - 1.0, p.y + (rand() % 1000) / 500.0 - 1.0);
     }
-
-    /*
-    Write each student to file in format: Name|Destination|CurrentLocation
-    Example output: John Smith|Saddar|Library
-    */
     for (int i = 0; i < count; i++) {
-        outFile << arr[i].name << "|"              // Write name + delimiter
-                << arr[i].destination << "|"        // Write destination + delimiter
-                << arr[i].currentLocation << endl;  // Write location + newline
+        char text[50];
+        StudentForm s;
+        snprintf(text, sizeof(text), "Student %d", i);
+        s.name = text;
+        s.destination = BENCH_DESTINATIONS[rand() % BENCH_DESTINATION_COUNT];
+        snprintf(text, sizeof(text), "Spot %d", rand() % spots);
+        s.currentLocation = text;
+        store.add(s);
     }
-
-    outFile.close(); // Close the file
 }
 
 /*
 ===============================================================================
-FUNCTION: registerStudent()
+FUNCTION: runProximityBenchmark()
 ===============================================================================
-Purpose: Register a new student OR update existing student's information
-Logic: If student name already exists, UPDATE their info; otherwise ADD new
+Purpose: Time nearest-partner queries on 100k students at known places,
+         against a brute-force scan that measures every student's distance
 Parameters: None
-Returns: void (nothing)
+Returns: int - 0 on success, 1 if the two methods disagree
 */
-void registerStudent() {
-    cout << "\n--- REGISTER / UPDATE STATUS ---\n";
-    
-    // Step 1: Load all existing students from file
-    Student students[100];  // Array to hold up to 100 students
-    int studentCount = loadStudentsFromFile(students, 100);
+int runProximityBenchmark() {
+    const int students = 100000;
+    const int queries = 1000;
+    const int k = NEAREST_PARTNERS;
+    StudentStore store;
+    generateMappedStudents(store, students, 7);
+    const char* const* destinations = BENCH_DESTINATIONS;
+    const char* const* locations = BENCH_LOCATIONS;
+    const int nd = BENCH_DESTINATION_COUNT;
+    const int nl = BENCH_LOCATION_COUNT;
 
-    // Step 2: Create a new Student structure for input
-    Student newStudent;
-    
-    // Step 3: Get student information from user
-    cout << "Enter your Name: ";
-    cin.getline(newStudent.name, 50);  // Read up to 49 characters (50th is '\0')
-
-    cout << "Enter your Destination (e.g., Saddar, Hayatabad): ";
-    cin.getline(newStudent.destination, 50);
+    double indexUs = 0, scanUs = 0;
+    for (int q = 0; q < queries; q++) {
+        const char* dest = destinations[q % nd];
+        const char* from = locations[q % nl];
 
-    cout << "Enter your Current Location (e.g., Library, Cafe): ";
-    cin.getline(newStudent.currentLocation, 50);
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        vector<NearbyMatch> fast;
+        store.findNearest(dest, from, k, NEARBY_DESTINATION_KM, fast);
+        indexUs += chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
 
-    /*
-    Step 4: Check if student already exists (case-insensitive search)
-    strcasecmp() compares two strings ignoring case differences
-    Returns 0 if strings are equal (ignoring case)
-    */
-    bool found = false;
-    for (int i = 0; i < studentCount; i++) {
-        // If we find a student with the same name (case-insensitive)
-        if (strcasecmp(students[i].name, newStudent.name) == 0) {
-            // UPDATE existing student's information
-            strcpy(students[i].destination, newStudent.destination);
-            strcpy(students[i].currentLocation, newStudent.currentLocation);
-            found = true;
-            cout << "\n✓ SUCCESS: Your details have been UPDATED!\n";
-            break; // Stop searching, we found the student
+        // Brute force: every student, distance to each, keep the k best
+        t0 = chrono::steady_clock::now();
+        Point fromPoint, destPoint;
+        CAMPUS_PLACES.lookup(from, fromPoint);
+        CAMPUS_PLACES.lookup(dest, destPoint);
+        vector<NearbyMatch> slow;
+        for (int i = 0; i < store.size(); i++) {
+            Point d, w;
+            if (!CAMPUS_PLACES.lookup(store.at(i).destination, d) || distanceKm(d, destPoint) > NEARBY_DESTINATION_KM) continue;
+            if (!CAMPUS_PLACES.lookup(store.at(i).currentLocation, w)) continue;
+            NearbyMatch m = { i, distanceKm(fromPoint, w) };
+            slow.push_back(m);
         }
-    }
+        sort(slow.begin(), slow.end(), closerMatch);
+        if ((int)slow.size() > k) slow.resize(k);
+        scanUs += chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
 
-    // Step 5: If student not found, add as NEW student
-    if (!found) {
-        // Check if array is full (100 students max)
-        if (studentCount >= 100) {
-            cout << "[ERROR] Database full (100 students max).\n";
-            return; // Exit function
+        if (fast.size() != slow.size() ||
+            (!fast.empty() && fabs(fast.back().distanceKm - slow.back().distanceKm) > 1e-9)) {
+            cout << "[ERROR] Index and scan disagree for " << dest << " from " << from << "\n";
+            return 1;
         }
-        
-        // Add new student to the array
-        students[studentCount] = newStudent;
-        studentCount++; // Increment count
-        cout << "\n✓ SUCCESS: You have been registered!\n";
     }
 
-    // Step 6: Save all students back to file (permanent storage)
-    saveAllStudentsToFile(students, studentCount);
-    cout << "[Info] Data saved to disk permanently.\n";
+    cout << "students\t" << students << "\n";
+    cout << "index_us_per_query\t" << indexUs / queries << "\n";
+    cout << "scan_us_per_query\t" << scanUs / queries << "\n";
+    return 0;
 }
 
 /*
 ===============================================================================
-FUNCTION: findRidePartners()
+FUNCTION: runGroupBenchmark()
 ===============================================================================
-Purpose: Search for students going to a specific destination
-Shows: Student names and their current locations
+Purpose: Time formRideGroups() at 10k and 100k students (4 seats each)
+Reports: Groups formed per second and the average detour per group
 Parameters: None
-Returns: void (nothing)
+Returns: int - 0, or 1 if some student ends up in no group or in two
 */
-void findRidePartners() {
-    char targetDest[50]; // To store destination user is searching for
-    cout << "\n--- FIND RIDE PARTNERS ---\n";
-    
-    // Step 1: Load all students from file
-    Student students[100];
-    int studentCount = loadStudentsFromFile(students, 100);
-    
-    // Step 2: Check if there's any data
-    if (studentCount == 0) {
-        cout << "No data found. Be the first to register!\n";
-        return; // Exit function
+int runGroupBenchmark() {
+    const int sizes[] = { 10000, 100000 };
+    int threads = (int)thread::hardware_concurrency();
+    if (threads <= 0) threads = 1;
+
+    cout << "students\tthreads\tgroups\tms\tgroups_per_second\tavg_detour_km\n";
+    for (int n = 0; n < 2; n++) {
+        StudentStore store;
+        generateMappedStudents(store, sizes[n], 11);
+
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        vector<RideGroup> groups;
+        formRideGroups(store, DEFAULT_VEHICLE_CAPACITY, threads, groups);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        // Every student must be in exactly one group
+        vector<char> seen(store.size(), 0);
+        double detour = 0;
+        int routed = 0;
+        for (size_t g = 0; g < groups.size(); g++) {
+            for (size_t m = 0; m < groups[g].members.size(); m++) {
+                if (seen[groups[g].members[m]]++) {
+                    cout << "[ERROR] Student in two groups.\n";
+                    return 1;
+                }
+            }
+            if (groups[g].hasRoute) {
+                detour += groups[g].detourKm;
+                routed++;
+            }
+        }
+        if (count(seen.begin(), seen.end(), 0) != 0) {
+            cout << "[ERROR] Student left without a group.\n";
+            return 1;
+        }
+
+        cout << sizes[n] << "\t" << threads << "\t" << groups.size() << "\t" << ms << "\t"
+             << (long)(groups.size() / (ms / 1000.0)) << "\t" << (routed ? detour / routed : 0) << "\n";
     }
-    
-    // Step 3: Ask user where they want to go
-    cout << "Where do you want to go? ";
-    cin.getline(targetDest, 50);
+    return 0;
+}
 
-    bool found = false; // Flag to track if we find any matches
+/*
+===============================================================================
+FUNCTION: runSearchBenchmark()
+===============================================================================
+Purpose: Time place autocomplete and typo-tolerant search at 1M students
+Logic: Generates 1M students over 5000 destinations, then simulates a user
+       typing "destination 1234" one letter at a time (one autocomplete per
+       keystroke) and searching with typos in it.
+Parameters: None
+Returns: int - 0
+*/
+int runSearchBenchmark() {
+    StudentStore store;
+    generateSyntheticStudents(store, 1000000, 5000, 5);
 
-    // Step 4: Display table header
-    cout << "\nSearching for students going to: " << targetDest << "...\n";
-    cout << "-----------------------------------------------------------\n";
-    cout << "Name\t\tCurrent Location\n";
-    cout << "----\t\t----------------\n";
+    const char* typed = "destination 1234";
+    const char* typos[] = { "destinaton 1234", "dstination 4321", "destination 12", "destinatoin 99", "Destination 4999" };
+    const int rounds = 50;
 
-    /*
-    Step 5: Search through all students
-    strcasecmp() does case-insensitive comparison
-    Example: "Saddar" matches "saddar", "SADDAR", "SaDdAr"
-    */
-    for (int i = 0; i < studentCount; i++) {
-        if (strcasecmp(students[i].destination, targetDest) == 0) {
-            // Found a match! Display the student info
-            cout << students[i].name << "\t\t" 
-                 << students[i].currentLocation << "\n";
-            found = true;
+    // Autocomplete: one query per keystroke
+    vector<PlaceSuggestion> out;
+    double completeUs = 0, worstUs = 0;
+    int keystrokes = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t len = 1; len <= strlen(typed); len++) {
+            string prefix(typed, len);
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            store.placeSearch().complete(prefix.c_str(), PlaceSearchIndex::DESTINATION, 10, out);
+            double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+            completeUs += us;
+            worstUs = max(worstUs, us);
+            keystrokes++;
         }
     }
 
-    // Step 6: Display appropriate message based on results
-    if (!found) {
-        cout << "No students found going to '" << targetDest << "' yet.\n";
-    } else {
-        cout << "-----------------------------------------------------------\n";
+    // Typo-tolerant search
+    double fuzzyUs = 0, fuzzyWorstUs = 0;
+    int searches = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (size_t t = 0; t < sizeof(typos) / sizeof(typos[0]); t++) {
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            store.placeSearch().suggest(typos[t], PlaceSearchIndex::DESTINATION, 10, out);
+            double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+            fuzzyUs += us;
+            fuzzyWorstUs = max(fuzzyWorstUs, us);
+            searches++;
+        }
     }
+
+    cout << "students\t" << store.size() << "\n";
+    cout << "complete_us_avg\t" << completeUs / keystrokes << "\n";
+    cout << "complete_us_worst\t" << worstUs << "\n";
+    cout << "fuzzy_us_avg\t" << fuzzyUs / searches << "\n";
+    cout << "fuzzy_us_worst\t" << fuzzyWorstUs << "\n";
+    return 0;
 }
 
 /*
 ===============================================================================
-FUNCTION: viewAllStudents()
+FUNCTION: runShardBenchmark()
 ===============================================================================
-Purpose: Display all registered students in a formatted table
-Shows: Serial number, Name, Destination, Current Location
-Parameters: None
-Returns: void (nothing)
+Purpose: "bench-shards" - compare a 1M-student database kept in one file
+         with the same students split over DEFAULT_SHARD_COUNT shards
+Measures (best of 3 runs each, on scratch files):
+  single_file_load_ms          loadStudentsFromFile()
+  shard_parse_ms / threads     only read and split the shards, T threads
+  shard_load_ms / threads      loadShards() with T threads (parse + add to the store)
+  find_*_ms                    one destination from the file vs from its shard
+  save_*_ms                    compaction after one registration: whole
+                               file vs only the changed shard
+Adding to the store is done by one thread, so the load can only speed up
+as far as the parsing part allows (Amdahl's law); the parse-only column
+shows how that part scales on its own. With one CPU core there is no gain.
+Returns: int - 0
 */
-void viewAllStudents() {
-    cout << "\n--- ALL REGISTERED STUDENTS ---\n";
-    
-    // Step 1: Load all students from file
-    Student students[100];
-    int studentCount = loadStudentsFromFile(students, 100);
-    
-    // Step 2: Check if database is empty
-    if (studentCount == 0) {
-        cout << "No students registered yet. Database is empty.\n";
-        return; // Exit function
+// Read and split files without loading them; counts rows going to 'destination' (every row if "")
+static long scanRecordFiles(const vector<string>& files, int threads, const string& destination) {
+    RecordLoader loader(files, threads);
+    vector<thread> pool;
+    for (int t = 1; t < threads; t++) pool.push_back(thread(RecordLoader::run, &loader));
+    long matches = 0;
+    for (size_t k = 0; RecordChunk* chunk = loader.waitFor(k); k++) {
+        for (size_t r = 0; r < chunk->rows.size(); r++) {
+            if (destination.empty() || strcasecmp(chunk->rows[r].destination, destination.c_str()) == 0) matches++;
+        }
+        loader.release(k);
     }
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+    return matches;
+}
 
-    // Step 3: Display table header
-    cout << "-----------------------------------------------------------\n";
-    cout << "#\tName\t\tDestination\tCurrent Location\n";
-    cout << "-\t----\t\t-----------\t----------------\n";
+int runShardBenchmark() {
+    const char* realDb = DB_FILE;
+    const char* realLog = LOG_FILE;
+    const char* realBin = BIN_FILE;
+    const char* realManifest = MANIFEST_FILE;
+    const char* realPrefix = SHARD_FILE_PREFIX;
+    DB_FILE = "ride_share_bench.txt";
+    LOG_FILE = "ride_share_bench.log";
+    BIN_FILE = "ride_share_bench.bin";
+    MANIFEST_FILE = "ride_share_bench.manifest";
+    SHARD_FILE_PREFIX = "ride_share_bench.shard-";
+    const int runs = 3;
+
+    // Step 1: The same roster as one file and as shards
+    ShardManifest manifest;
+    manifest.create(DEFAULT_SHARD_COUNT);
+    string target;
+    {
+        StudentStore store;
+        RosterSpec spec;
+        spec.students = 1000000;
+        RosterGenerator generator(spec);
+        StudentForm s;
+        store.reserve(spec.students);
+        for (int i = 0; i < spec.students; i++) {
+            generator.next(i, s);
+            store.add(s);
+        }
+        target = store.at(0).destination;
+        saveAllStudentsToFile(store);
+        saveShards(store, manifest, false);
+    }
+    cout << "students\t1000000\tshards\t" << manifest.shardCount()
+         << "\tcores\t" << thread::hardware_concurrency() << "\n";
 
-    // Step 4: Loop through and display each student
-    for (int i = 0; i < studentCount; i++) {
-        cout << (i+1) << "\t"                           // Serial number (starting from 1)
-             << students[i].name << "\t\t" 
-             << students[i].destination << "\t\t" 
-             << students[i].currentLocation << "\n";
+    // Step 2: Loading
+    double fileMs = 1e300;
+    for (int r = 0; r < runs; r++) {
+        StudentStore store;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        loadStudentsFromFile(store);
+        fileMs = min(fileMs, msSince(t0));
     }
+    cout << "single_file_load_ms\t" << fileMs << "\n";
 
-    // Step 5: Display footer with total count
-    cout << "-----------------------------------------------------------\n";
-    cout << "Total students: " << studentCount << "\n";
+    cout << "threads\tshard_parse_ms\tparse_speedup\tshard_load_ms\tload_speedup\n";
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    double parseBase = 0, loadBase = 0;
+    for (int t = 0; t < 4; t++) {
+        int threads = threadCounts[t];
+        double parseMs = 1e300, loadMs = 1e300;
+        for (int r = 0; r < runs; r++) {
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            scanRecordFiles(manifest.files, threads, "");
+            parseMs = min(parseMs, msSince(t0));
+
+            StudentStore store;
+            t0 = chrono::steady_clock::now();
+            loadShards(store, manifest, threads);
+            loadMs = min(loadMs, msSince(t0));
+        }
+        if (t == 0) {
+            parseBase = parseMs;
+            loadBase = loadMs;
+        }
+        cout << threads << "\t" << parseMs << "\t" << parseBase / parseMs << "\t"
+             << loadMs << "\t" << loadBase / loadMs << "\n";
+    }
+
+    // Step 3: One destination, from the whole file vs from its shard
+    double findFileMs = 1e300, findShardMs = 1e300;
+    long fileMatches = 0, shardMatches = 0;
+    for (int r = 0; r < runs; r++) {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        fileMatches = scanRecordFiles(vector<string>(1, DB_FILE), 1, target);
+        findFileMs = min(findFileMs, msSince(t0));
+
+        t0 = chrono::steady_clock::now();
+        vector<string> shard(1, manifest.files[shardOf(normalizeKey(target.c_str()), manifest.shardCount())]);
+        shardMatches = scanRecordFiles(shard, 1, target);
+        findShardMs = min(findShardMs, msSince(t0));
+    }
+    cout << "find_file_ms\t" << findFileMs << "\t(" << fileMatches << " going to '" << target << "')\n";
+    cout << "find_shard_ms\t" << findShardMs << "\t(" << shardMatches << ")\n";
+
+    // Step 4: Compaction after one registration
+    double saveFileMs = 1e300, saveShardMs = 1e300;
+    {
+        StudentStore store;
+        loadShards(store, manifest, 0);
+        for (int r = 0; r < runs; r++) {
+            store.markSaved();
+            StudentForm s;
+            s.name = "Bench Student";
+            s.destination = target;
+            s.currentLocation = "Library";
+            setDepartureWindow(s, r, DEFAULT_DEPARTURE_WINDOW_MIN);
+            int existing = store.findByName(s.name.c_str());
+            if (existing >= 0) store.update(existing, s);
+            else store.add(s);
+
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            saveAllStudentsToFile(store);
+            saveFileMs = min(saveFileMs, msSince(t0));
+
+            t0 = chrono::steady_clock::now();
+            saveShards(store, manifest, true);
+            saveShardMs = min(saveShardMs, msSince(t0));
+        }
+    }
+    cout << "save_file_ms\t" << saveFileMs << "\n";
+    cout << "save_one_shard_ms\t" << saveShardMs << "\n";
+
+    remove(DB_FILE);
+    remove(MANIFEST_FILE);
+    for (int i = 0; i < manifest.shardCount(); i++) remove(manifest.files[i].c_str());
+    DB_FILE = realDb;
+    LOG_FILE = realLog;
+    BIN_FILE = realBin;
+    MANIFEST_FILE = realManifest;
+    SHARD_FILE_PREFIX = realPrefix;
+    return 0;
 }
 
 /*
 ===============================================================================
-FUNCTION: clearAllData()
+FUNCTION: runParseBenchmark()
 ===============================================================================
-Purpose: Delete ALL student records from the database
-Warning: This is PERMANENT and cannot be undone!
-Parameters: None
-Returns: void (nothing)
+Purpose: "bench-parse" - how fast database lines are split, the old way
+         (getline + parseRecordLine()) against splitRecords() with each
+         delimiter scan this CPU supports, then whole-file loading
+How it works: 1M synthetic lines (plus one with a 2000-byte name, which
+  must be rejected) are built in memory. Each method splits a fresh copy
+  of the text; the copy is not timed. Best of 3 runs.
+Columns:
+  method       old, scalar, sse2 or avx2
+  ms / mb_s    time for all lines, and megabytes of text per second
+  rows         lines accepted
+  rejected     lines skipped for a field over MAX_FIELD_BYTES
+Then the same text as a scratch DB_FILE: split only (1-8 threads) and a
+full load into the store, old vs new.
+Returns: int - 0
 */
-void clearAllData() {
-    // Step 1: Load students to check if there's any data
-    Student students[100];
-    int studentCount = loadStudentsFromFile(students, 100);
-    
-    // Step 2: If database is already empty
-    if (studentCount == 0) {
-        cout << "No data to clear.\n";
-        return; // Exit function
+int runParseBenchmark() {
+    const int STUDENTS = 1000000;
+    const int RUNS = 3;
+
+    // Step 1: The text
+    string text;
+    {
+        RosterSpec spec;
+        spec.students = STUDENTS;
+        RosterGenerator generator(spec);
+        StudentForm s;
+        char times[40];
+        for (int i = 0; i < STUDENTS; i++) {
+            generator.next(i, s);
+            setDepartureWindow(s, i % 120, DEFAULT_DEPARTURE_WINDOW_MIN);
+            snprintf(times, sizeof(times), "|%u|%u|%u\n", s.registeredAt, s.departFrom, s.departUntil);
+            text += s.name + "|" + s.destination + "|" + s.currentLocation + times;
+            if (i == STUDENTS / 2) text += string(2000, 'x') + "|Saddar|Library\n";
+        }
     }
+    double mb = text.size() / (1024.0 * 1024.0);
+    cout << "lines\t" << STUDENTS + 1 << "\tmb\t" << mb << "\n";
+    cout << "method\tms\tmb_s\trows\trejected\n";
 
-    // Step 3: Ask for confirmation (safety feature)
-    char confirm;
-    cout << "\n⚠️  WARNING: This will delete ALL " << studentCount << " student records!\n";
-    cout << "Are you sure? (y/n): ";
-    cin >> confirm;
-    cin.ignore(); // Clear newline from buffer
+    // Step 2: Old parser, line by line
+    double oldMs = 1e300;
+    long oldRows = 0;
+    for (int r = 0; r < RUNS; r++) {
+        istringstream in(text);
+        string line;
+        StudentForm s;
+        oldRows = 0;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        while (getline(in, line)) {
+            parseRecordLine(line, s);
+            oldRows++;
+        }
+        oldMs = min(oldMs, msSince(t0));
+    }
+    cout << "old\t" << oldMs << "\t" << mb / (oldMs / 1000) << "\t" << oldRows << "\t0\n";
 
-    // Step 4: Only proceed if user confirms with 'y' or 'Y'
-    if (confirm == 'y' || confirm == 'Y') {
-        /*
-        Clear file by opening in truncate mode
-        ios::trunc flag truncates (empties) the file
-        This effectively deletes all content
-        */
-        ofstream outFile(DB_FILE, ios::trunc);
-        outFile.close();
-        cout << "✓ All data has been permanently deleted.\n";
-    } 
-    else {
-        cout << "Operation cancelled.\n"; // User said no
+    // Step 3: splitRecords() with each scan
+    struct Method { const char* name; DelimiterScan scan; };
+    vector<Method> methods;
+    Method scalar = { "scalar", scanDelimitersScalar };
+    methods.push_back(scalar);
+#if RIDE_SHARE_X86
+    Method sse2 = { "sse2", scanDelimitersSse2 };
+    methods.push_back(sse2);
+    if (__builtin_cpu_supports("avx2")) {
+        Method avx2 = { "avx2", scanDelimitersAvx2 };
+        methods.push_back(avx2);
+    }
+#endif
+    vector<char> work(text.size());
+    vector<StudentView> rows;
+    for (size_t m = 0; m < methods.size(); m++) {
+        double best = 1e300;
+        long rejected = 0;
+        for (int r = 0; r < RUNS; r++) {
+            memcpy(&work[0], text.data(), text.size());
+            rows.clear();
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            rejected = splitRecords(&work[0], work.size(), methods[m].scan, rows);
+            best = min(best, msSince(t0));
+        }
+        cout << methods[m].name << "\t" << best << "\t" << mb / (best / 1000) << "\t"
+             << rows.size() << "\t" << rejected << "\n";
+    }
+    vector<char>().swap(work);
+    vector<StudentView>().swap(rows);
+
+    // Step 4: From a file: read + split on 1-8 threads, then a full load
+    const char* realDb = DB_FILE;
+    DB_FILE = "ride_share_bench.txt";
+    {
+        ofstream out(DB_FILE, ios::binary);
+        out.write(text.data(), text.size());
+    }
+    string().swap(text);
+
+    cout << "threads\tread_split_ms\tmb_s\n";
+    const int threadCounts[] = { 1, 2, 4, 8 };
+    for (int t = 0; t < 4; t++) {
+        double best = 1e300;
+        for (int r = 0; r < RUNS; r++) {
+            chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+            scanRecordFiles(vector<string>(1, DB_FILE), threadCounts[t], "");
+            best = min(best, msSince(t0));
+        }
+        cout << threadCounts[t] << "\t" << best << "\t" << mb / (best / 1000) << "\n";
     }
+
+    double oldLoadMs = 1e300, newLoadMs = 1e300;
+    for (int r = 0; r < RUNS; r++) {
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        {
+            StudentStore store;
+            ifstream in(DB_FILE);
+            string line;
+            StudentForm s;
+            while (getline(in, line)) {
+                if (line.empty()) continue;
+                parseRecordLine(line, s);
+                store.add(s);
+            }
+        }
+        oldLoadMs = min(oldLoadMs, msSince(t0));
+
+        t0 = chrono::steady_clock::now();
+        {
+            StudentStore store;
+            loadStudentsFromFile(store);
+        }
+        newLoadMs = min(newLoadMs, msSince(t0));
+    }
+    cout << "load_old_ms\t" << oldLoadMs << "\n";
+    cout << "load_new_ms\t" << newLoadMs << "\n";
+
+    remove(DB_FILE);
+    DB_FILE = realDb;
+    return 0;
 }
 
 /*
@@ -509,8 +6291,10 @@ END OF PROGRAM
 ===============================================================================
 Key Concepts Used in This Program:
 1. Structures (struct) - Custom data types
-2. Arrays - Fixed-size collections
+2. Classes & std::vector - StudentStore, a growable in-memory collection
+   Hash index (unordered_map) - Fast case-insensitive destination lookup
 3. File I/O - Reading/writing persistent data
+   Write-ahead log - Append small changes, compact into a snapshot later
 4. String manipulation - C-style string functions
 5. Loops - while, for
 6. Conditionals - if/else
@@ -518,9 +6302,10 @@ Key Concepts Used in This Program:
 8. Input validation - Handling user errors
 
 Data Flow:
-1. User input → Memory (array)
-2. Memory (array) → File (permanent storage)
-3. File → Memory (array) → Display to user
+1. Startup: File → Memory (StudentStore), loaded once
+2. User input → Memory (StudentStore) → Change log (append one line)
+   Change log gets long → Snapshot rewritten to DB_FILE, log emptied
+3. Memory (StudentStore) → Display to user
 
 File Format (pipe-delimited):
 Name|Destination|CurrentLocation